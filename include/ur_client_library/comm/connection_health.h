@@ -0,0 +1,171 @@
+// this is for emacs file handling -*- mode: c++; indent-tabs-mode: nil -*-
+
+// -- BEGIN LICENSE BLOCK ----------------------------------------------
+// Copyright 2026 Universal Robots A/S
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -- END LICENSE BLOCK ------------------------------------------------
+
+//----------------------------------------------------------------------
+/*!\file
+ *
+ * \date    2026-10-19
+ *
+ */
+//----------------------------------------------------------------------
+
+#ifndef UR_CLIENT_LIBRARY_CONNECTION_HEALTH_H_INCLUDED
+#define UR_CLIENT_LIBRARY_CONNECTION_HEALTH_H_INCLUDED
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+
+namespace urcl
+{
+namespace comm
+{
+/*!
+ * \brief Health states of a connection that is expected to receive data continuously.
+ */
+enum class ConnectionHealth
+{
+  UNKNOWN = 0,  ///< No data has been received since the monitor was (re)started.
+  HEALTHY = 1,  ///< Data is arriving in time.
+  STALE = 2,    ///< No data has been received for longer than the stale timeout.
+  LOST = 3      ///< No data has been received for longer than the loss timeout. The link is considered dead.
+};
+
+/*!
+ * \brief Monitors a connection that receives data continuously (such as a running RTDE stream)
+ * and reports link loss within a bounded time.
+ *
+ * Whoever reads from the connection calls notifyReceived() for every package and check()
+ * regularly while waiting for data. State transitions are reported through a callback that is
+ * executed inside those calls.
+ *
+ * The monitor only reports a connection as LOST after having seen data on it. A connection that is
+ * intentionally silent (e.g. a paused RTDE stream) should be suspend()ed while it is silent, as
+ * stray data received in that time would otherwise arm the monitor again.
+ */
+class ConnectionHealthMonitor
+{
+public:
+  using Clock = std::chrono::steady_clock;
+
+  ConnectionHealthMonitor();
+  virtual ~ConnectionHealthMonitor() = default;
+
+  /*!
+   * \brief Configures after which times without data a connection is considered stale or lost.
+   *
+   * \param stale_timeout Time without data after which the connection is considered STALE
+   * \param lost_timeout Time without data after which the connection is considered LOST. 0
+   * disables monitoring.
+   */
+  void setTimeouts(const std::chrono::milliseconds stale_timeout, const std::chrono::milliseconds lost_timeout);
+
+  /*!
+   * \brief Getter for the time without data after which the connection is considered lost.
+   *
+   * \returns The loss timeout. 0 means monitoring is disabled.
+   */
+  std::chrono::milliseconds getLostTimeout() const
+  {
+    return lost_timeout_.load();
+  }
+
+  /*!
+   * \brief Returns whether the monitor is enabled, i.e. a loss timeout has been configured.
+   */
+  bool isEnabled() const
+  {
+    return lost_timeout_.load().count() > 0;
+  }
+
+  /*!
+   * \brief Registers a callback that is triggered on every change of the connection health.
+   *
+   * \param callback Function receiving the new health state
+   */
+  void setHealthCallback(std::function<void(ConnectionHealth)> callback)
+  {
+    callback_ = callback;
+  }
+
+  /*!
+   * \brief Resets the monitor to the UNKNOWN state.
+   */
+  void reset();
+
+  /*!
+   * \brief Stops evaluating the connection health and resets it to UNKNOWN until resume() is
+   * called. Data received in the meantime doesn't change the health.
+   */
+  void suspend();
+
+  /*!
+   * \brief Resumes evaluating the connection health after suspend(). The health stays UNKNOWN
+   * until new data is received.
+   */
+  void resume();
+
+  /*!
+   * \brief Returns whether the monitor is suspended.
+   */
+  bool isSuspended() const
+  {
+    return suspended_;
+  }
+
+  /*!
+   * \brief Notifies the monitor that data has been received on the connection.
+   *
+   * \param time Time at which the data was received
+   */
+  void notifyReceived(const Clock::time_point& time = Clock::now());
+
+  /*!
+   * \brief Evaluates the connection health based on the time since the last data was received.
+   *
+   * \param now The current time
+   *
+   * \returns The connection health after evaluation
+   */
+  ConnectionHealth check(const Clock::time_point& now = Clock::now());
+
+  /*!
+   * \brief Getter for the last evaluated connection health.
+   *
+   * \returns The connection health
+   */
+  ConnectionHealth getHealth() const
+  {
+    return health_;
+  }
+
+private:
+  void transition(const ConnectionHealth health);
+
+  std::atomic<ConnectionHealth> health_;
+  std::atomic<Clock::rep> last_receive_;
+  std::atomic<bool> suspended_;
+  std::atomic<std::chrono::milliseconds> stale_timeout_;
+  std::atomic<std::chrono::milliseconds> lost_timeout_;
+  std::function<void(ConnectionHealth)> callback_;
+};
+
+}  // namespace comm
+}  // namespace urcl
+
+#endif  // ifndef UR_CLIENT_LIBRARY_CONNECTION_HEALTH_H_INCLUDED
@@ -38,14 +38,17 @@ namespace comm
  */
 enum class ControlMode : int32_t
 {
-  MODE_STOPPED = -2,        ///< When this is set, the program is expected to stop and exit.
-  MODE_UNINITIALIZED = -1,  ///< Startup default until another mode is sent to the script.
-  MODE_IDLE = 0,            ///< Set when no controller is currently active controlling the robot.
-  MODE_SERVOJ = 1,          ///< Set when servoj control is active.
-  MODE_SPEEDJ = 2,          ///< Set when speedj control is active.
-  MODE_FORWARD = 3,         ///< Set when trajectory forwarding is active.
-  MODE_SPEEDL = 4,          ///< Set when cartesian velocity control is active.
-  MODE_POSE = 5             ///< Set when cartesian pose control is active.
+  MODE_STOPPED = -2,            ///< When this is set, the program is expected to stop and exit.
+  MODE_UNINITIALIZED = -1,      ///< Startup default until another mode is sent to the script.
+  MODE_IDLE = 0,                ///< Set when no controller is currently active controlling the robot.
+  MODE_SERVOJ = 1,              ///< Set when servoj control is active.
+  MODE_SPEEDJ = 2,              ///< Set when speedj control is active.
+  MODE_FORWARD = 3,             ///< Set when trajectory forwarding is active.
+  MODE_SPEEDL = 4,              ///< Set when cartesian velocity control is active.
+  MODE_POSE = 5,                ///< Set when cartesian pose control is active.
+  MODE_SERVOJ_TIMESTAMPED = 6,  ///< Set when servoj control with latency compensation is active.
+  MODE_FORCE = 7,               ///< Set when force mode control is active.
+  MODE_KEEPALIVE = 8            ///< Only refreshes the keepalive, the active mode and setpoint are kept.
 };
 }  // namespace comm
 }  // namespace urcl
@@ -28,6 +28,8 @@
 #ifndef UR_CLIENT_LIBRARY_PACKAGE_H_INCLUDED
 #define UR_CLIENT_LIBRARY_PACKAGE_H_INCLUDED
 
+#include <chrono>
+
 #include "ur_client_library/comm/bin_parser.h"
 
 namespace urcl
@@ -67,10 +69,49 @@ public:
    */
   virtual std::string toString() const = 0;
 
+  /*!
+   * \brief Stores the times at which this package was received and parsed.
+   *
+   * \param kernel_receive_time Time the package was received by the kernel
+   * \param parsed_time Time the package finished parsing in user space
+   */
+  void setReceiveTimestamps(const std::chrono::system_clock::time_point& kernel_receive_time,
+                            const std::chrono::system_clock::time_point& parsed_time)
+  {
+    kernel_receive_time_ = kernel_receive_time;
+    parsed_time_ = parsed_time;
+  }
+
+  /*!
+   * \brief Getter for the time at which this package was received by the kernel.
+   *
+   * The difference to getParsedTime() is the time spent reading and parsing the package, while
+   * the difference between getParsedTime() and the time the package is taken out of a pipeline
+   * is the time it spent queueing.
+   *
+   * \returns The kernel receive time or a default constructed time point if unknown.
+   */
+  std::chrono::system_clock::time_point getKernelReceiveTime() const
+  {
+    return kernel_receive_time_;
+  }
+
+  /*!
+   * \brief Getter for the time at which parsing of this package finished.
+   *
+   * \returns The parse time or a default constructed time point if unknown.
+   */
+  std::chrono::system_clock::time_point getParsedTime() const
+  {
+    return parsed_time_;
+  }
+
   using HeaderType = HeaderT;
 
 private:
   HeaderT header_;
+  std::chrono::system_clock::time_point kernel_receive_time_;
+  std::chrono::system_clock::time_point parsed_time_;
 };
 }  // namespace comm
 }  // namespace urcl
@@ -25,6 +25,9 @@
 #include "ur_client_library/queue/readerwriterqueue.h"
 #include <atomic>
 #include <chrono>
+#include <functional>
+#include <memory>
+#include <pthread.h>
 #include <thread>
 #include <vector>
 #include <fstream>
@@ -78,6 +81,159 @@ public:
   virtual bool consume(std::shared_ptr<T> product) = 0;
 };
 
+/*!
+ * \brief Describes how often a consumer wants to receive products.
+ */
+struct RatePolicy
+{
+  enum class Type
+  {
+    ALL,              //!< Every product is passed on
+    EVERY_NTH,        //!< Only every n-th product is passed on
+    MIN_PERIOD,       //!< A product is passed on if at least \p period passed since the last one
+    LATEST_AT_PERIOD  //!< Only the latest product is passed on, once per \p period
+  };
+
+  Type type = Type::ALL;
+  size_t n = 1;
+  std::chrono::nanoseconds period = std::chrono::nanoseconds(0);
+
+  static RatePolicy all()
+  {
+    return RatePolicy();
+  }
+  static RatePolicy everyNth(const size_t n)
+  {
+    RatePolicy policy;
+    policy.type = Type::EVERY_NTH;
+    policy.n = n > 0 ? n : 1;
+    return policy;
+  }
+  static RatePolicy minPeriod(const std::chrono::nanoseconds period)
+  {
+    RatePolicy policy;
+    policy.type = Type::MIN_PERIOD;
+    policy.period = period;
+    return policy;
+  }
+  static RatePolicy latestAtPeriod(const std::chrono::nanoseconds period)
+  {
+    RatePolicy policy;
+    policy.type = Type::LATEST_AT_PERIOD;
+    policy.period = period;
+    return policy;
+  }
+};
+
+/*!
+ * \brief Consumer decimating the products before handing them to another consumer.
+ *
+ * Products that are dropped by the policy are never seen by the wrapped consumer. With
+ * RatePolicy::Type::LATEST_AT_PERIOD products are released on a fixed time grid, so the rate
+ * doesn't drift with the arrival times of the products. A pending product is also released from
+ * onTimeout(), i.e. when no new products arrive.
+ *
+ * @tparam T Type of the consumed products
+ */
+template <typename T>
+class RateLimitedConsumer : public IConsumer<T>
+{
+public:
+  /*!
+   * \brief Creates a new RateLimitedConsumer object.
+   *
+   * \param consumer The consumer receiving the products passing the policy
+   * \param policy Rate policy to apply
+   */
+  RateLimitedConsumer(IConsumer<T>& consumer, const RatePolicy& policy)
+    : consumer_(consumer), policy_(policy), count_(0)
+  {
+  }
+
+  virtual void setupConsumer()
+  {
+    consumer_.setupConsumer();
+  }
+  virtual void teardownConsumer()
+  {
+    consumer_.teardownConsumer();
+  }
+  virtual void stopConsumer()
+  {
+    consumer_.stopConsumer();
+  }
+  virtual void onTimeout()
+  {
+    if (latest_ && std::chrono::steady_clock::now() >= next_release_)
+    {
+      release();
+    }
+    consumer_.onTimeout();
+  }
+
+  /*!
+   * \brief Passes the product on, if the rate policy allows it.
+   *
+   * \param product Shared pointer to the product to be consumed.
+   *
+   * \returns Success of the consumption. Dropped products count as consumed successfully.
+   */
+  bool consume(std::shared_ptr<T> product)
+  {
+    switch (policy_.type)
+    {
+      case RatePolicy::Type::EVERY_NTH:
+        return count_++ % policy_.n == 0 ? consumer_.consume(product) : true;
+      case RatePolicy::Type::MIN_PERIOD:
+      {
+        const auto now = std::chrono::steady_clock::now();
+        if (count_ > 0 && now - last_release_ < policy_.period)
+        {
+          return true;
+        }
+        ++count_;
+        last_release_ = now;
+        return consumer_.consume(product);
+      }
+      case RatePolicy::Type::LATEST_AT_PERIOD:
+      {
+        latest_ = product;
+        const auto now = std::chrono::steady_clock::now();
+        if (count_ == 0)
+        {
+          next_release_ = now;
+        }
+        return now >= next_release_ ? release() : true;
+      }
+      default:
+        return consumer_.consume(product);
+    }
+  }
+
+private:
+  bool release()
+  {
+    const auto now = std::chrono::steady_clock::now();
+    ++count_;
+    next_release_ += policy_.period;
+    if (next_release_ <= now)
+    {
+      // We fell behind by more than one period, realign the grid instead of bursting.
+      next_release_ = now + policy_.period;
+    }
+    std::shared_ptr<T> product;
+    product.swap(latest_);
+    return consumer_.consume(product);
+  }
+
+  IConsumer<T>& consumer_;
+  RatePolicy policy_;
+  size_t count_;
+  std::chrono::steady_clock::time_point last_release_;
+  std::chrono::steady_clock::time_point next_release_;
+  std::shared_ptr<T> latest_;
+};
+
 /*!
  * \brief Consumer, that allows one product to be consumed by multiple arbitrary
  * conusmers.
@@ -89,6 +245,7 @@ class MultiConsumer : public IConsumer<T>
 {
 private:
   std::vector<IConsumer<T>*> consumers_;
+  std::vector<std::unique_ptr<RateLimitedConsumer<T>>> rate_limiters_;
 
 public:
   /*!
@@ -100,6 +257,24 @@ public:
   {
   }
 
+  /*!
+   * \brief Adds a consumer that only receives the products passing the given rate policy. This
+   * has to be done before the pipeline is started.
+   *
+   * \param consumer Consumer to add
+   * \param policy Rate policy applied before products are handed to the consumer
+   */
+  void addConsumer(IConsumer<T>* consumer, const RatePolicy& policy = RatePolicy::all())
+  {
+    if (policy.type == RatePolicy::Type::ALL)
+    {
+      consumers_.push_back(consumer);
+      return;
+    }
+    rate_limiters_.emplace_back(new RateLimitedConsumer<T>(*consumer, policy));
+    consumers_.push_back(rate_limiters_.back().get());
+  }
+
   /*!
    * \brief Sets up all registered consumers.
    */
@@ -246,7 +421,13 @@ public:
    * \param notifier The notifier to use
    */
   Pipeline(IProducer<T>& producer, IConsumer<T>* consumer, std::string name, INotifier& notifier)
-    : producer_(producer), consumer_(consumer), name_(name), notifier_(notifier), queue_{ 32 }, running_{ false }
+    : producer_(producer)
+    , consumer_(consumer)
+    , name_(name)
+    , notifier_(notifier)
+    , queue_{ 32 }
+    , running_{ false }
+    , producer_cpu_(-1)
   {
   }
   /*!
@@ -258,7 +439,13 @@ public:
    * \param notifier The notifier to use
    */
   Pipeline(IProducer<T>& producer, std::string name, INotifier& notifier)
-    : producer_(producer), consumer_(nullptr), name_(name), notifier_(notifier), queue_{ 32 }, running_{ false }
+    : producer_(producer)
+    , consumer_(nullptr)
+    , name_(name)
+    , notifier_(notifier)
+    , queue_{ 32 }
+    , running_{ false }
+    , producer_cpu_(-1)
   {
   }
 
@@ -318,6 +505,41 @@ public:
     notifier_.stopped(name_);
   }
 
+  /*!
+   * \brief Returns whether the pipeline has been started and not stopped since.
+   */
+  bool isRunning() const
+  {
+    return running_;
+  }
+
+  /*!
+   * \brief Pins the producer thread to a CPU core. This takes effect the next time the pipeline is
+   * started.
+   *
+   * This is mainly useful in combination with a busy-polling stream, where the producer thread
+   * should run on an isolated core.
+   *
+   * \param cpu Index of the CPU core to pin the producer thread to. -1 disables pinning.
+   */
+  void setProducerCPUAffinity(const int cpu)
+  {
+    producer_cpu_ = cpu;
+  }
+
+  /*!
+   * \brief Registers a function that is called on the producer thread for every product before it
+   * is put into the queue. This can be used to take certain products out of the stream, e.g. to
+   * handle them separately. This should be set before the pipeline is started.
+   *
+   * \param router Function receiving each product. If it returns true, it has taken ownership of
+   * the product and the product won't be queued.
+   */
+  void setProductRouter(std::function<bool(std::unique_ptr<T>&)> router)
+  {
+    router_ = router;
+  }
+
   /*!
    * \brief Returns the most recent package in the queue. Can be used instead of registering a consumer. If the queue
    * already contains one or more items, the queue will be flushed and the newest item will be returned. If there is no
@@ -349,10 +571,27 @@ private:
   moodycamel::BlockingReaderWriterQueue<std::unique_ptr<T>> queue_;
   std::atomic<bool> running_;
   std::thread pThread_, cThread_;
+  int producer_cpu_;
+  std::function<bool(std::unique_ptr<T>&)> router_;
 
   void runProducer()
   {
     URCL_LOG_DEBUG("Starting up producer");
+    if (producer_cpu_ >= 0)
+    {
+      cpu_set_t cpuset;
+      CPU_ZERO(&cpuset);
+      CPU_SET(producer_cpu_, &cpuset);
+      int ret = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
+      if (ret != 0)
+      {
+        URCL_LOG_ERROR("Unsuccessful in pinning producer thread to CPU %d. Error code: %d", producer_cpu_, ret);
+      }
+      else
+      {
+        URCL_LOG_INFO("Producer thread pinned to CPU %d", producer_cpu_);
+      }
+    }
     std::ifstream realtime_file("/sys/kernel/realtime", std::ios::in);
     bool has_realtime;
     realtime_file >> has_realtime;
@@ -417,6 +656,10 @@ private:
 
       for (auto& p : products)
       {
+        if (router_ && router_(p))
+        {
+          continue;
+        }
         if (!queue_.tryEnqueue(std::move(p)))
         {
           URCL_LOG_ERROR("Pipeline producer overflowed! <%s>", name_.c_str());
@@ -19,7 +19,13 @@
  */
 
 #pragma once
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include "ur_client_library/comm/connection_health.h"
 #include "ur_client_library/comm/pipeline.h"
 #include "ur_client_library/comm/parser.h"
 #include "ur_client_library/comm/stream.h"
@@ -30,10 +36,43 @@ namespace urcl
 {
 namespace comm
 {
+/*!
+ * \brief Connection states of a URProducer
+ */
+enum class ProducerState
+{
+  DISCONNECTED = 0,           ///< The producer has not been connected, yet.
+  CONNECTED = 1,              ///< The stream is connected and packages are being read.
+  WAITING_FOR_RECONNECT = 2,  ///< The connection was lost and the producer waits before reconnecting.
+  RECONNECTING = 3            ///< The producer is trying to reconnect the stream.
+};
+
+/*!
+ * \brief Configures how a URProducer deals with packages that cannot be parsed.
+ *
+ * By default, a package that cannot be parsed stops the producer. In resync mode, the offending
+ * package is dropped instead. As packages are read from the stream based on their length header,
+ * the stream stays in sync with the package boundaries. The producer only stops if packages have
+ * to be dropped too often.
+ */
+struct ResyncConfig
+{
+  bool enabled = false;                            ///< Drop malformed packages instead of stopping
+  uint32_t max_errors = 10;                        ///< Maximum number of dropped packages per error window
+  std::chrono::milliseconds error_window{ 1000 };  ///< Time window in which dropped packages are counted
+};
+
 /*!
  * \brief A general producer for URPackages. Implements funcionality to produce packages by
  * reading and parsing from a byte stream.
  *
+ * If the connection gets lost, the producer reconnects the stream. A connection is considered lost
+ * if reading fails or, unless link loss detection is suspended, no data has been received for
+ * DEFAULT_LINK_LOSS_TIMEOUT. setLinkLossTimeout() replaces that timeout. Reconnecting is done step by step in
+ * consecutive tryGet() calls, waiting between reconnection attempts according to the stream's
+ * ConnectionConfig. All waits are interrupted by stopProducer(), so a pipeline using this
+ * producer can be stopped at any time.
+ *
  * @tparam HeaderT Header type of packages to produce.
  */
 template <typename T>
@@ -42,18 +81,156 @@ class URProducer : public IProducer<T>
 private:
   URStream<T>& stream_;
   Parser<T>& parser_;
-  std::chrono::seconds timeout_;
+  ConnectionHealthMonitor health_monitor_;
+
+  std::atomic<bool> running_;
+  std::atomic<ProducerState> state_;
+  std::function<void(ProducerState)> state_callback_;
+
+  ResyncConfig resync_;
+  std::atomic<uint64_t> dropped_packages_;
+  uint32_t window_errors_;
+  std::chrono::steady_clock::time_point window_start_;
+
+  // Time of the last received data or (re)connection, to detect silent links
+  std::atomic<std::chrono::steady_clock::rep> last_data_;
+
+  std::chrono::milliseconds reconnect_delay_;
+  std::chrono::steady_clock::time_point reconnect_time_;
+  std::mutex reconnect_mutex_;
+  std::condition_variable reconnect_cv_;
+
+  void markData()
+  {
+    last_data_ = std::chrono::steady_clock::now().time_since_epoch().count();
+  }
+
+  bool linkLost()
+  {
+    if (health_monitor_.isEnabled())
+    {
+      return health_monitor_.check() == ConnectionHealth::LOST;
+    }
+    const std::chrono::steady_clock::time_point last_data{ std::chrono::steady_clock::duration(last_data_) };
+    return !health_monitor_.isSuspended() &&
+           std::chrono::steady_clock::now() - last_data > DEFAULT_LINK_LOSS_TIMEOUT;
+  }
+
+  std::chrono::milliseconds linkLossTimeout() const
+  {
+    return health_monitor_.isEnabled() ? health_monitor_.getLostTimeout() : DEFAULT_LINK_LOSS_TIMEOUT;
+  }
 
-  bool running_;
+  timeval receiveTimeout() const
+  {
+    // A read timeout serves to regularly check whether the producer is still running, which bounds
+    // the time needed to stop it, and whether the link has been silent for too long.
+    std::chrono::milliseconds timeout(100);
+    if (health_monitor_.isEnabled())
+    {
+      timeout = std::max(std::chrono::milliseconds(1), std::min(timeout, health_monitor_.getLostTimeout() / 4));
+    }
+    timeval tv;
+    tv.tv_sec = timeout.count() / 1000;
+    tv.tv_usec = (timeout.count() % 1000) * 1000;
+    return tv;
+  }
+
+  void transition(const ProducerState state)
+  {
+    if (state_.exchange(state) != state && state_callback_)
+    {
+      state_callback_(state);
+    }
+  }
+
+  bool dropMalformedPackage(std::vector<std::unique_ptr<T>>& products, const size_t first_new)
+  {
+    if (!resync_.enabled)
+      return false;
+
+    // Remove whatever has been parsed from the broken package
+    products.resize(first_new);
+    dropped_packages_.fetch_add(1, std::memory_order_relaxed);
+
+    auto now = std::chrono::steady_clock::now();
+    if (now - window_start_ > resync_.error_window)
+    {
+      window_start_ = now;
+      window_errors_ = 0;
+    }
+    if (++window_errors_ > resync_.max_errors)
+    {
+      URCL_LOG_ERROR("More than %u packages could not be parsed within %ld ms. Giving up on this stream.",
+                     resync_.max_errors, resync_.error_window.count());
+      return false;
+    }
+
+    URCL_LOG_WARN("Dropped a package that could not be parsed (%lu dropped in total).",
+                  dropped_packages_.load(std::memory_order_relaxed));
+    return true;
+  }
+
+  void scheduleReconnect()
+  {
+    reconnect_time_ = std::chrono::steady_clock::now() + reconnect_delay_;
+    URCL_LOG_WARN("Reconnecting in %ld ms...", reconnect_delay_.count());
+    transition(ProducerState::WAITING_FOR_RECONNECT);
+  }
+
+  bool waitForReconnect()
+  {
+    std::unique_lock<std::mutex> lock(reconnect_mutex_);
+    reconnect_cv_.wait_until(lock, reconnect_time_, [this]() { return !running_; });
+    return running_;
+  }
+
+  void reconnect()
+  {
+    transition(ProducerState::RECONNECTING);
+
+    // Only try once, waiting between attempts is done by the producer itself so it stays
+    // interruptible.
+    const ConnectionConfig config = stream_.getConnectionConfig();
+    const bool connected = running_ && stream_.connect(true);
+
+    if (connected)
+    {
+      URCL_LOG_INFO("Connection re-established");
+      reconnect_delay_ = config.initial_backoff;
+      // A new connection has to deliver data before it can be considered lost again.
+      health_monitor_.reset();
+      markData();
+      transition(ProducerState::CONNECTED);
+      return;
+    }
+
+    reconnect_delay_ = std::min(
+        config.max_backoff,
+        std::chrono::duration_cast<std::chrono::milliseconds>(reconnect_delay_ * config.backoff_factor));
+    scheduleReconnect();
+  }
 
 public:
+  //! Time without data after which a connection is considered lost, unless configured otherwise
+  //! using setLinkLossTimeout()
+  constexpr static const std::chrono::milliseconds DEFAULT_LINK_LOSS_TIMEOUT = std::chrono::milliseconds(1000);
+
   /*!
    * \brief Creates a URProducer object, registering a stream and a parser.
    *
    * \param stream The stream to read from
    * \param parser The parser to use to interpret received byte information
    */
-  URProducer(URStream<T>& stream, Parser<T>& parser) : stream_(stream), parser_(parser), timeout_(1), running_(false)
+  URProducer(URStream<T>& stream, Parser<T>& parser)
+    : stream_(stream)
+    , parser_(parser)
+    , running_(false)
+    , state_(ProducerState::DISCONNECTED)
+    , dropped_packages_(0)
+    , window_errors_(0)
+    , last_data_(0)
+    , reconnect_delay_(stream.getConnectionConfig().initial_backoff)
   {
   }
 
@@ -62,14 +239,14 @@ public:
    */
   void setupProducer() override
   {
-    timeval tv;
-    tv.tv_sec = 1;
-    tv.tv_usec = 0;
-    stream_.setReceiveTimeout(tv);
+    stream_.setReceiveTimeout(receiveTimeout());
     if (!stream_.connect())
     {
       throw UrException("Failed to connect to robot. Please check if the robot is booted and connected.");
     }
+    reconnect_delay_ = stream_.getConnectionConfig().initial_backoff;
+    markData();
+    transition(ProducerState::CONNECTED);
   }
   /*!
    * \brief Tears down the producer. Currently no special handling needed.
@@ -79,61 +256,224 @@ public:
     stopProducer();
   }
   /*!
-   * \brief Stops the producer. Currently no functionality needed.
+   * \brief Stops the producer, interrupting any pending reconnection.
    */
   void stopProducer() override
   {
-    running_ = false;
+    {
+      std::lock_guard<std::mutex> lock(reconnect_mutex_);
+      running_ = false;
+    }
+    reconnect_cv_.notify_all();
+    stream_.cancelSetup();
   }
 
   void startProducer() override
   {
+    // A stop without a pending reconnection must not cancel the next one.
+    stream_.resetSetupCancellation();
     running_ = true;
   }
 
+  /*!
+   * \brief Getter for the connection state of the producer.
+   *
+   * \returns The current state
+   */
+  ProducerState getState() const
+  {
+    return state_;
+  }
+
+  /*!
+   * \brief Registers a callback that is triggered from the producer thread whenever the connection
+   * state of the producer changes. The callback should return quickly, as no packages are read
+   * while it is executed.
+   *
+   * \param callback Function receiving the new state
+   */
+  void setStateCallback(std::function<void(ProducerState)> callback)
+  {
+    state_callback_ = callback;
+  }
+
+  /*!
+   * \brief Configures how packages that cannot be parsed are handled. This should not be changed
+   * while the producer is running.
+   *
+   * \param config Resync configuration to use
+   */
+  void setResyncConfig(const ResyncConfig& config)
+  {
+    resync_ = config;
+    window_errors_ = 0;
+  }
+
+  /*!
+   * \brief Getter for the number of packages dropped in resync mode since the producer was
+   * created.
+   *
+   * \returns The number of dropped packages
+   */
+  uint64_t getDroppedPackages() const
+  {
+    return dropped_packages_.load(std::memory_order_relaxed);
+  }
+
+  /*!
+   * \brief Configures the time without data after which the link is considered lost, replacing
+   * DEFAULT_LINK_LOSS_TIMEOUT.
+   *
+   * If no package arrives for longer than the given timeout while the connection is open, the
+   * connection is considered lost and the producer reconnects. Half of the timeout without data
+   * marks the connection as stale, which is reported through the connection health. Unlike the
+   * default timeout, a configured timeout only applies after data has been received on the
+   * connection.
+   *
+   * \param timeout Time without data after which the link is considered lost. 0 restores the
+   * default.
+   */
+  void setLinkLossTimeout(const std::chrono::milliseconds timeout)
+  {
+    health_monitor_.setTimeouts(timeout / 2, timeout);
+    if (stream_.getState() == SocketState::Connected)
+    {
+      stream_.setReceiveTimeout(receiveTimeout());
+    }
+  }
+
+  /*!
+   * \brief Registers a callback that is triggered from the producer thread whenever the health of
+   * the connection changes.
+   *
+   * \param callback Function receiving the new connection health
+   */
+  void setConnectionHealthCallback(std::function<void(ConnectionHealth)> callback)
+  {
+    health_monitor_.setHealthCallback(callback);
+  }
+
+  /*!
+   * \brief Getter for the current health of the connection.
+   *
+   * \returns The connection health as last evaluated by the producer
+   */
+  ConnectionHealth getConnectionHealth() const
+  {
+    return health_monitor_.getHealth();
+  }
+
+  /*!
+   * \brief Suspends link loss detection. This has to be called when the remote side is expected
+   * to stop sending data, e.g. while a stream is paused.
+   */
+  void suspendConnectionHealth()
+  {
+    health_monitor_.suspend();
+  }
+
+  /*!
+   * \brief Resumes link loss detection suspended by suspendConnectionHealth(). The connection is
+   * only considered lost again after new data has been received.
+   */
+  void resumeConnectionHealth()
+  {
+    markData();
+    health_monitor_.resume();
+  }
+
   /*!
    * \brief Attempts to read byte stream from the robot and parse it as a URPackage.
    *
+   * If the connection is currently lost, this performs the next step of reconnecting instead. In
+   * that case, true is returned without adding any products.
+   *
    * \param products Unique pointer to hold the produced package
    *
-   * \returns Success of reading and parsing the package
+   * \returns Success of reading and parsing the package, false if the stream has been closed
    */
   bool tryGet(std::vector<std::unique_ptr<T>>& products) override
   {
-    // TODO This function has become really ugly! That should be refactored!
+    switch (state_)
+    {
+      case ProducerState::WAITING_FOR_RECONNECT:
+        if (waitForReconnect())
+        {
+          reconnect();
+        }
+        return true;
+      case ProducerState::RECONNECTING:
+        reconnect();
+        return true;
+      default:
+        break;
+    }
 
     // 4KB should be enough to hold any packet received from UR
     uint8_t buf[4096];
     size_t read = 0;
-    // expoential backoff reconnects
-    while (true)
+    const ReadStatus status = stream_.readPackage(buf, sizeof(buf), read, resync_.enabled);
+    if (status == ReadStatus::SUCCESS)
     {
-      if (stream_.read(buf, sizeof(buf), read))
+      health_monitor_.notifyReceived();
+      markData();
+      BinParser bp(buf, read);
+      size_t first_new = products.size();
+      bool parsed = false;
+      try
+      {
+        parsed = parser_.parse(bp, products);
+      }
+      catch (const UrException& e)
+      {
+        URCL_LOG_ERROR("%s", e.what());
+      }
+      if (!parsed)
       {
-        // reset sleep amount
-        timeout_ = std::chrono::seconds(1);
-        BinParser bp(buf, read);
-        return parser_.parse(bp, products);
+        return dropMalformedPackage(products, first_new);
       }
 
-      if (!running_)
-        return true;
+      auto parsed_time = std::chrono::system_clock::now();
+      for (size_t i = first_new; i < products.size(); ++i)
+      {
+        products[i]->setReceiveTimestamps(stream_.getPackageReceiveTime(), parsed_time);
+      }
+      return true;
+    }
 
-      if (stream_.closed())
-        return false;
+    if (status == ReadStatus::OVERSIZE && resync_.enabled)
+    {
+      // The package has been skipped, so the stream is still in sync.
+      health_monitor_.notifyReceived();
+      markData();
+      return dropMalformedPackage(products, products.size());
+    }
 
-      URCL_LOG_WARN("Failed to read from stream, reconnecting in %ld seconds...", timeout_.count());
-      std::this_thread::sleep_for(timeout_);
+    if (!running_)
+      return true;
 
-      if (stream_.connect())
-        continue;
+    if (status == ReadStatus::TIMEOUT && stream_.getState() == SocketState::Connected)
+    {
+      // No data within the receive timeout. Unless this has been going on for too long, simply
+      // return without products so the caller can go on.
+      if (!linkLost())
+        return true;
 
-      auto next = timeout_ * 2;
-      if (next <= std::chrono::seconds(120))
-        timeout_ = next;
+      URCL_LOG_ERROR("No data received for more than %ld ms, considering the connection as lost.",
+                     linkLossTimeout().count());
+    }
+    else if (stream_.closed())
+    {
+      return false;
+    }
+    else
+    {
+      URCL_LOG_WARN("Failed to read from stream, connection lost.");
     }
 
-    return false;
+    stream_.disconnect();
+    scheduleReconnect();
+    return true;
   }
 };
 }  // namespace comm
@@ -0,0 +1,66 @@
+// this is for emacs file handling -*- mode: c++; indent-tabs-mode: nil -*-
+
+// -- BEGIN LICENSE BLOCK ----------------------------------------------
+// Copyright 2026 Universal Robots A/S
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -- END LICENSE BLOCK ------------------------------------------------
+
+//----------------------------------------------------------------------
+/*!\file
+ *
+ * \date    2026-10-19
+ *
+ */
+//----------------------------------------------------------------------
+
+#ifndef UR_CLIENT_LIBRARY_SOCKET_OPTIONS_H_INCLUDED
+#define UR_CLIENT_LIBRARY_SOCKET_OPTIONS_H_INCLUDED
+
+#include <chrono>
+
+namespace urcl
+{
+namespace comm
+{
+/*!
+ * \brief Configuration of TCP keepalive and user timeout for a socket.
+ *
+ * The kernel defaults for TCP keepalive take hours to detect a dead peer. With this
+ * configuration, a pulled cable can be detected within seconds by the kernel. Note that keepalive
+ * times have a granularity of one second, so detecting link loss faster than that has to be done
+ * on the application level, e.g. using a ConnectionHealthMonitor.
+ */
+struct KeepaliveConfig
+{
+  bool enabled = false;                         ///< Apply this configuration. If false, kernel defaults are used.
+  std::chrono::milliseconds user_timeout{ 0 };  ///< TCP_USER_TIMEOUT for unacknowledged data. 0 keeps the default.
+  std::chrono::seconds idle{ 1 };               ///< TCP_KEEPIDLE: Idle time before sending keepalive probes
+  std::chrono::seconds interval{ 1 };           ///< TCP_KEEPINTVL: Time between two keepalive probes
+  int count = 3;                                ///< TCP_KEEPCNT: Unanswered probes before dropping the connection
+};
+
+/*!
+ * \brief Applies a keepalive configuration to a socket.
+ *
+ * \param socket_fd File descriptor of the socket to configure
+ * \param config Configuration to apply
+ *
+ * \returns True if all options could be set or the configuration is disabled, false otherwise
+ */
+bool applyKeepaliveConfig(const int socket_fd, const KeepaliveConfig& config);
+
+}  // namespace comm
+}  // namespace urcl
+
+#endif  // ifndef UR_CLIENT_LIBRARY_SOCKET_OPTIONS_H_INCLUDED
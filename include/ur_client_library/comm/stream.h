@@ -22,6 +22,7 @@
 #include <netdb.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <algorithm>
 #include <atomic>
 #include <mutex>
 #include <string>
@@ -56,11 +57,14 @@ public:
   /*!
    * \brief Connects to the configured socket.
    *
+   * \param single_try Only try to connect once instead of retrying as configured by the
+   * ConnectionConfig
+   *
    * \returns True on success, false if connection could not be established
    */
-  bool connect()
+  bool connect(const bool single_try = false)
   {
-    return TCPSocket::setup(host_, port_);
+    return TCPSocket::setup(host_, port_, single_try);
   }
 
   /*!
@@ -93,6 +97,25 @@ public:
    */
   bool read(uint8_t* buf, const size_t buf_len, size_t& read);
 
+  /*!
+   * \brief Reads a full UR package out of a socket like read(), reporting why no package could be
+   * read.
+   *
+   * A package larger than the buffer can be skipped using its length header, which keeps the stream
+   * in sync. Otherwise, the rest of the package remains in the stream, so it has to be reconnected.
+   *
+   * \param[out] buf The byte buffer where the content shall be stored
+   * \param[in] buf_len Number of bytes allocated for the buffer
+   * \param[out] read Number of bytes of the package stored in the buffer
+   * \param[in] skip_oversize Whether to skip packages larger than the buffer
+   *
+   * \returns ReadStatus::SUCCESS if a package has been read, ReadStatus::OVERSIZE if a package was
+   * larger than the buffer, ReadStatus::TIMEOUT if no package started within the receive timeout.
+   * ReadStatus::FAILED is returned if the stream is out of sync, e.g. after a timeout in the middle
+   * of a package.
+   */
+  ReadStatus readPackage(uint8_t* buf, const size_t buf_len, size_t& read, const bool skip_oversize);
+
   /*!
    * \brief Writes directly to the underlying socket (with a mutex guard)
    *
@@ -114,16 +137,32 @@ public:
     return host_;
   }
 
-protected:
-  virtual bool open(int socket_fd, struct sockaddr* address, size_t address_len)
+  /*!
+   * \brief Get the port
+   *
+   * \returns The port the stream connects to
+   */
+  int getPort() const
   {
-    return ::connect(socket_fd, address, address_len) == 0;
+    return port_;
+  }
+
+  /*!
+   * \brief Getter for the time at which the first bytes of the last package read with read() were
+   * received by the kernel.
+   *
+   * \returns The receive time of the last read package
+   */
+  std::chrono::system_clock::time_point getPackageReceiveTime() const
+  {
+    return package_receive_time_;
   }
 
 private:
   std::string host_;
   int port_;
   std::mutex write_mutex_, read_mutex_;
+  std::chrono::system_clock::time_point package_receive_time_;
 };
 
 template <typename T>
@@ -135,34 +174,78 @@ bool URStream<T>::write(const uint8_t* buf, const size_t buf_len, size_t& writte
 
 template <typename T>
 bool URStream<T>::read(uint8_t* buf, const size_t buf_len, size_t& total)
+{
+  return readPackage(buf, buf_len, total, false) == ReadStatus::SUCCESS;
+}
+
+template <typename T>
+ReadStatus URStream<T>::readPackage(uint8_t* buf, const size_t buf_len, size_t& total, const bool skip_oversize)
 {
   std::lock_guard<std::mutex> lock(read_mutex_);
 
-  bool initial = true;
-  uint8_t* buf_pos = buf;
-  size_t remainder = sizeof(typename T::HeaderType::_package_size_type);
-  size_t read = 0;
+  const size_t header_size = sizeof(typename T::HeaderType::_package_size_type);
+  size_t remainder = header_size;
+  size_t consumed = 0;
+  bool discarding = false;
+  uint8_t discard_buffer[256];
+  total = 0;
 
-  while (remainder > 0 && TCPSocket::read(buf_pos, remainder, read))
+  while (remainder > 0)
   {
-    TCPSocket::setOptions(getSocketFD());
-    if (initial)
+    uint8_t* target = discarding ? discard_buffer : buf + total;
+    const size_t chunk = discarding ? std::min(remainder, sizeof(discard_buffer)) : remainder;
+    size_t read = 0;
+    const ReadStatus status = TCPSocket::tryRead(target, chunk, read);
+    if (status != ReadStatus::SUCCESS)
     {
-      remainder = T::HeaderType::getPackageLength(buf);
-      if (remainder >= (buf_len - sizeof(typename T::HeaderType::_package_size_type)))
+      if (status == ReadStatus::TIMEOUT && consumed > 0)
       {
-        URCL_LOG_ERROR("Packet size %zd is larger than buffer %zu, discarding.", remainder, buf_len);
-        return false;
+        URCL_LOG_ERROR("Timed out in the middle of a package, the stream is out of sync.");
+        return ReadStatus::FAILED;
       }
-      initial = false;
+      return status;
     }
+    TCPSocket::setOptions(getSocketFD());
 
-    total += read;
-    buf_pos += read;
+    if (consumed == 0)
+    {
+      package_receive_time_ = getLastReceiveTime();
+    }
+    consumed += read;
     remainder -= read;
+    if (!discarding)
+    {
+      total += read;
+    }
+
+    // The length is known as soon as the whole size field has been read.
+    if (consumed == header_size)
+    {
+      const size_t length = T::HeaderType::getPackageLength(buf);
+      if (length < header_size)
+      {
+        URCL_LOG_ERROR("Invalid package size %zu, the stream is out of sync.", length);
+        return ReadStatus::FAILED;
+      }
+      if (length > buf_len)
+      {
+        URCL_LOG_ERROR("Packet size %zu is larger than buffer %zu, discarding.", length, buf_len);
+        if (!skip_oversize)
+        {
+          return ReadStatus::OVERSIZE;
+        }
+        discarding = true;
+      }
+      remainder = length - header_size;
+    }
   }
 
-  return remainder == 0;
+  if (discarding)
+  {
+    return ReadStatus::OVERSIZE;
+  }
+  packages_read_.fetch_add(1, std::memory_order_relaxed);
+  return ReadStatus::SUCCESS;
 }
 }  // namespace comm
 }  // namespace urcl
@@ -35,9 +35,12 @@
 #include <unistd.h>
 
 #include <atomic>
+#include <chrono>
 #include <functional>
 #include <thread>
 
+#include "ur_client_library/comm/socket_options.h"
+
 namespace urcl
 {
 namespace comm
@@ -124,6 +127,34 @@ public:
    */
   bool write(const int fd, const uint8_t* buf, const size_t buf_len, size_t& written);
 
+  /*!
+   * \brief Writes to a client without blocking. If the socket's send buffer is full, only a part
+   * or nothing of the buffer is written.
+   *
+   * \param[in] fd File descriptor belonging to the client the data should be sent to
+   * \param[in] buf Buffer of bytes to write
+   * \param[in] buf_len Number of bytes in the buffer
+   * \param[out] written Number of bytes actually written, possibly less than \p buf_len
+   *
+   * \returns True on success, including partial writes, false if the socket failed
+   */
+  bool writeNonBlocking(const int fd, const uint8_t* buf, const size_t buf_len, size_t& written);
+
+  /*!
+   * \brief Writes to a client, waiting at most the given time for the socket's send buffer to
+   * accept the whole buffer.
+   *
+   * \param[in] fd File descriptor belonging to the client the data should be sent to
+   * \param[in] buf Buffer of bytes to write
+   * \param[in] buf_len Number of bytes in the buffer
+   * \param[out] written Number of bytes actually written, less than \p buf_len if the timeout passed
+   * \param[in] timeout Maximum time to wait for the socket to become writable
+   *
+   * \returns True on success, including partial writes, false if the socket failed
+   */
+  bool writeNonBlocking(const int fd, const uint8_t* buf, const size_t buf_len, size_t& written,
+                        const std::chrono::milliseconds timeout);
+
   /*!
    * \brief Get the maximum number of clients allowed to connect to this server
    *
@@ -145,6 +176,30 @@ public:
     max_clients_allowed_ = max_clients_allowed;
   }
 
+  /*!
+   * \brief Configures TCP keepalive and the user timeout for client connections.
+   *
+   * The configuration is applied to all clients connecting after this call. It should be set before
+   * calling start().
+   *
+   * \param config Keepalive configuration to use
+   */
+  void setKeepaliveConfig(const KeepaliveConfig& config)
+  {
+    keepalive_ = config;
+  }
+
+  /*!
+   * \brief Getter for the port the server is bound to. If the server was created with port 0, this
+   * is the port assigned by the operating system.
+   *
+   * \returns The port the server is bound to
+   */
+  int getPort() const
+  {
+    return port_;
+  }
+
 private:
   void init();
   void bind();
@@ -177,6 +232,8 @@ private:
   uint32_t max_clients_allowed_;
   std::vector<int> client_fds_;
 
+  KeepaliveConfig keepalive_;
+
   // Pipe for the self-pipe trick (https://cr.yp.to/docs/selfpipe.html)
   int self_pipe_[2];
 
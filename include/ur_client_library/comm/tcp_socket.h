@@ -22,11 +22,17 @@
 #include <netdb.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
 #include <mutex>
 #include <string>
 #include <memory>
 
+#include "ur_client_library/comm/socket_options.h"
+
 namespace urcl
 {
 namespace comm
@@ -42,6 +48,61 @@ enum class SocketState
   Closed         ///< Connection to socket got closed
 };
 
+/*!
+ * \brief Outcome of reading from a socket
+ */
+enum class ReadStatus
+{
+  SUCCESS,   ///< Data has been read
+  TIMEOUT,   ///< No data arrived within the receive timeout
+  OVERSIZE,  ///< A package was larger than the buffer and has been discarded
+  CLOSED,    ///< The socket is not connected or the remote side closed the connection
+  FAILED     ///< Reading failed, e.g. due to a socket error or a package cut off by a timeout
+};
+
+/*!
+ * \brief Configuration of how a socket establishes its connection.
+ *
+ * All resolved addresses of a host are raced against each other using non-blocking connects,
+ * with the start of each further address being staggered. If no address could be connected,
+ * the attempt is repeated after a backoff time that grows with every failed attempt.
+ */
+struct ConnectionConfig
+{
+  std::chrono::milliseconds connect_timeout{ 1000 };  ///< Time to wait for a single connect to succeed
+  std::chrono::milliseconds address_stagger{ 250 };   ///< Delay before racing the next resolved address
+  std::chrono::milliseconds initial_backoff{ 100 };   ///< Delay before retrying after the first failed attempt
+  std::chrono::milliseconds max_backoff{ 10000 };     ///< Upper limit for the delay between attempts
+  double backoff_factor = 2.0;                        ///< Factor the delay grows with after each failed attempt
+  size_t max_num_tries = 0;                           ///< Maximum number of connection attempts. 0 means unlimited.
+};
+
+/*!
+ * \brief Configuration of the busy-poll receive mode of a socket.
+ *
+ * In busy-poll mode, reading from the socket spins on non-blocking receive calls instead of
+ * sleeping inside a blocking receive. This avoids the scheduler wake-up latency at the cost of
+ * keeping one CPU core busy. It is meant to be used together with a polling thread pinned to an
+ * isolated core.
+ */
+struct BusyPollConfig
+{
+  bool enabled = false;          ///< Whether reading should spin on non-blocking receives
+  uint32_t spin_budget = 10000;  ///< Non-blocking receive attempts before falling back to a blocking receive
+  int kernel_busy_poll_us = 50;  ///< Value for SO_BUSY_POLL in microseconds. 0 disables kernel-side busy polling.
+};
+
+/*!
+ * \brief Statistics gathered while reading from a socket in busy-poll mode.
+ */
+struct BusyPollStatistics
+{
+  uint64_t spin_iterations = 0;  ///< Non-blocking receive attempts that returned without data
+  uint64_t spin_reads = 0;       ///< Receive calls that got data while spinning
+  uint64_t blocking_reads = 0;   ///< Receive calls that fell back to blocking after exceeding the spin budget
+  uint64_t packages = 0;         ///< Complete packages read from the socket
+};
+
 /*!
  * \brief Class for TCP socket abstraction
  */
@@ -51,16 +112,58 @@ private:
   std::atomic<int> socket_fd_;
   std::atomic<SocketState> state_;
 
+  BusyPollConfig busy_poll_;
+  std::atomic<uint64_t> spin_iterations_;
+  std::atomic<uint64_t> spin_reads_;
+  std::atomic<uint64_t> blocking_reads_;
+
+  std::chrono::system_clock::time_point last_receive_time_;
+
+  ConnectionConfig connection_config_;
+  mutable std::mutex config_mutex_;
+  KeepaliveConfig keepalive_;
+  std::atomic<bool> setup_cancelled_;
+  std::mutex setup_mutex_;
+  std::condition_variable setup_cv_;
+
+  int raceConnect(struct addrinfo* addresses);
+  bool waitForRetry(const std::chrono::milliseconds& delay);
+  void applyBusyPollOptions(int socket_fd);
+  ssize_t receive(uint8_t* buf, const size_t buf_len, const int flags);
+  ssize_t spinReceive(uint8_t* buf, const size_t buf_len);
+
 protected:
-  virtual bool open(int socket_fd, struct sockaddr* address, size_t address_len)
+  /*!
+   * \brief Connects the given socket to the given address, blocking until it is connected.
+   *
+   * \deprecated setup() connects to all resolved addresses concurrently and doesn't call this
+   * anymore, so overriding it has no effect. It is only kept for subclasses that call it directly.
+   *
+   * \returns True on success, false otherwise
+   */
+  [[deprecated("setup() doesn't use open() anymore")]] virtual bool open(int socket_fd, struct sockaddr* address,
+                                                                         size_t address_len)
   {
-    return false;
+    return ::connect(socket_fd, address, address_len) == 0;
   }
+
   virtual void setOptions(int socket_fd);
 
-  bool setup(std::string& host, int port);
+  /*!
+   * \brief Connects the socket to the given host and port according to the configured
+   * ConnectionConfig.
+   *
+   * \param host Host name or IP address to connect to
+   * \param port Port to connect to
+   * \param single_try Only try once, regardless of the configured number of tries
+   *
+   * \returns True on success, false if the connection could not be established within the
+   * configured number of tries or if the setup was canceled using cancelSetup().
+   */
+  bool setup(const std::string& host, const int port, const bool single_try = false);
 
   std::unique_ptr<timeval> recv_timeout_;
+  std::atomic<uint64_t> packages_read_;
 
 public:
   /*!
@@ -116,6 +219,32 @@ public:
    */
   bool read(uint8_t* buf, const size_t buf_len, size_t& read);
 
+  /*!
+   * \brief Reads data from the socket, reporting why nothing could be read.
+   *
+   * \param[out] buf Buffer where the data shall be stored
+   * \param[in] buf_len Number of bytes allocated for the buffer
+   * \param[out] read Number of bytes actually read
+   *
+   * \returns ReadStatus::SUCCESS if data has been read, the reason for failing otherwise
+   */
+  ReadStatus tryRead(uint8_t* buf, const size_t buf_len, size_t& read);
+
+  /*!
+   * \brief Getter for the time at which the data returned by the last successful read() was
+   * received.
+   *
+   * This is the kernel's receive timestamp (SO_TIMESTAMPNS) if available. Otherwise, the time at
+   * which the receive call returned is used. As the kernel timestamps are taken from the realtime
+   * clock, this is a std::chrono::system_clock time point.
+   *
+   * \returns The receive time of the last read data
+   */
+  std::chrono::system_clock::time_point getLastReceiveTime() const
+  {
+    return last_receive_time_;
+  }
+
   /*!
    * \brief Writes to the socket
    *
@@ -138,6 +267,71 @@ public:
    * \param timeout Timeout used for setting things up
    */
   void setReceiveTimeout(const timeval& timeout);
+
+  /*!
+   * \brief Configures how connections are established by this socket. This takes effect upon the
+   * next connection attempt.
+   *
+   * \param config Connection configuration to use
+   */
+  void setConnectionConfig(const ConnectionConfig& config)
+  {
+    std::lock_guard<std::mutex> lock(config_mutex_);
+    connection_config_ = config;
+  }
+
+  /*!
+   * \brief Getter for the connection configuration of this socket.
+   *
+   * \returns The currently used connection configuration
+   */
+  ConnectionConfig getConnectionConfig() const
+  {
+    std::lock_guard<std::mutex> lock(config_mutex_);
+    return connection_config_;
+  }
+
+  /*!
+   * \brief Cancels a connection setup currently running in another thread.
+   *
+   * The running setup will stop waiting for connections or retries as soon as possible and report
+   * a failed connection. If no setup is running, the next one is canceled, so a cancellation racing
+   * with the start of a setup isn't lost. Use resetSetupCancellation() to revoke it.
+   */
+  void cancelSetup();
+
+  /*!
+   * \brief Revokes a cancellation requested by cancelSetup() that wasn't consumed by a setup yet.
+   */
+  void resetSetupCancellation();
+
+  /*!
+   * \brief Configures TCP keepalive and the user timeout of this socket.
+   *
+   * The options are applied immediately if the socket is connected, otherwise upon the next
+   * connection.
+   *
+   * \param config Keepalive configuration to use
+   */
+  void setKeepaliveConfig(const KeepaliveConfig& config);
+
+  /*!
+   * \brief Configures the busy-poll receive mode of this socket.
+   *
+   * Socket options are applied immediately if the socket is connected, otherwise upon the next
+   * connection. The configuration should not be changed while another thread is reading from the
+   * socket.
+   *
+   * \param config Busy-poll configuration to use
+   */
+  void setBusyPolling(const BusyPollConfig& config);
+
+  /*!
+   * \brief Get the statistics gathered in busy-poll mode.
+   *
+   * \returns A snapshot of the current busy-poll statistics
+   */
+  BusyPollStatistics getBusyPollStatistics() const;
 };
 }  // namespace comm
 }  // namespace urcl
@@ -0,0 +1,161 @@
+// this is for emacs file handling -*- mode: c++; indent-tabs-mode: nil -*-
+
+// -- BEGIN LICENSE BLOCK ----------------------------------------------
+// Copyright 2026 Universal Robots A/S
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -- END LICENSE BLOCK ------------------------------------------------
+
+//----------------------------------------------------------------------
+/*!\file
+ *
+ * \date    2026-10-19
+ *
+ */
+//----------------------------------------------------------------------
+
+
+#ifndef UR_CLIENT_LIBRARY_PHASE_LOCKED_SCHEDULER_H_INCLUDED
+#define UR_CLIENT_LIBRARY_PHASE_LOCKED_SCHEDULER_H_INCLUDED
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace urcl
+{
+namespace control
+{
+/*!
+ * \brief Statistics about how far ahead of the robot's cycle commands were issued.
+ */
+struct PhaseMarginStatistics
+{
+  uint64_t cycles = 0;                        //!< Number of callback invocations
+  uint64_t late = 0;                          //!< Invocations finishing after the predicted tick
+  std::chrono::nanoseconds min_margin{ 0 };   //!< Smallest margin observed
+  std::chrono::nanoseconds max_margin{ 0 };   //!< Largest margin observed
+  std::chrono::nanoseconds mean_margin{ 0 };  //!< Average margin
+};
+
+/*!
+ * \brief Triggers a control callback at a fixed phase relative to the robot's control cycle.
+ *
+ * The robot sends an RTDE package every control cycle. Their arrival times, passed in through
+ * onPackage(), are tracked by a phase-locked loop estimating both the phase and the actual period
+ * of the robot's cycle. A scheduler thread then wakes up \p lead before each predicted arrival and
+ * calls the control callback, so that a command written from the callback reaches the robot just
+ * before its next cycle instead of at a random phase.
+ *
+ * The phase margin, i.e. the time between the callback returning and the predicted arrival, is
+ * recorded for every cycle.
+ */
+class PhaseLockedScheduler
+{
+public:
+  PhaseLockedScheduler() = delete;
+  /*!
+   * \brief Creates a new PhaseLockedScheduler.
+   *
+   * \param period Nominal period of the robot's control cycle, e.g. 2ms for 500 Hz
+   * \param lead Time before the predicted package arrival at which the callback is triggered
+   */
+  PhaseLockedScheduler(const std::chrono::nanoseconds period, const std::chrono::nanoseconds lead);
+  virtual ~PhaseLockedScheduler();
+
+  /*!
+   * \brief Feeds the arrival time of an RTDE package into the phase estimation.
+   *
+   * \param arrival Time the package was received, ideally the kernel receive time
+   */
+  void onPackage(const std::chrono::steady_clock::time_point arrival);
+
+  /*!
+   * \brief Feeds the arrival time of an RTDE package into the phase estimation.
+   *
+   * \param arrival Time the package was received, e.g. DataPackage::getKernelReceiveTime(). If
+   * it is not set, i.e. the epoch, the current time is used instead.
+   */
+  void onPackage(const std::chrono::system_clock::time_point arrival);
+
+  /*!
+   * \brief Forgets the estimated phase and period, e.g. after the connection to the robot was
+   * lost. The scheduler thread keeps running, but doesn't call the callback until the next package
+   * has been received.
+   */
+  void reset();
+
+  /*!
+   * \brief Predicts the first package arrival after the given time.
+   *
+   * \param after Point in time to predict the next arrival for
+   * \param tick Predicted arrival
+   *
+   * \returns False if no package has been received yet, true otherwise
+   */
+  bool predictTick(const std::chrono::steady_clock::time_point after,
+                   std::chrono::steady_clock::time_point& tick) const;
+
+  /*!
+   * \brief Starts the scheduler thread calling \p callback once per robot cycle.
+   *
+   * \param callback Control callback, typically computing and writing the next command
+   */
+  void start(std::function<void()> callback);
+
+  /*!
+   * \brief Stops the scheduler thread.
+   */
+  void stop();
+
+  /*!
+   * \brief Estimated period of the robot's control cycle.
+   */
+  std::chrono::nanoseconds getPeriod() const;
+
+  /*!
+   * \brief Phase margin statistics since the scheduler was started.
+   */
+  PhaseMarginStatistics getStatistics() const;
+
+private:
+  void run();
+  std::chrono::steady_clock::time_point nextTick(const std::chrono::steady_clock::time_point after) const;
+
+  // Gains of the phase-locked loop. Low gains average out the network jitter.
+  constexpr static const double PHASE_GAIN = 0.05;
+  constexpr static const double FREQUENCY_GAIN = 0.001;
+
+  mutable std::mutex mutex_;
+  std::condition_variable locked_cv_;
+  bool locked_;
+  double period_;  // in nanoseconds
+  const double nominal_period_;
+  std::chrono::steady_clock::time_point reference_;
+  std::chrono::nanoseconds lead_;
+
+  std::function<void()> callback_;
+  std::thread thread_;
+  std::atomic<bool> running_;
+
+  PhaseMarginStatistics statistics_;
+  int64_t margin_sum_;
+};
+
+}  // namespace control
+}  // namespace urcl
+
+#endif  // UR_CLIENT_LIBRARY_PHASE_LOCKED_SCHEDULER_H_INCLUDED
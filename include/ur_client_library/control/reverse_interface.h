@@ -35,7 +35,12 @@
 #include "ur_client_library/log.h"
 #include <cstring>
 #include <endian.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <mutex>
 
 namespace urcl
 {
@@ -51,6 +56,56 @@ enum class TrajectoryControlMessage : int32_t
   TRAJECTORY_START = 1,    ///< Represents command to start a new trajectory.
 };
 
+/*!
+ * \brief Types of force frames as interpreted by URScript's force_mode().
+ */
+enum class ForceModeType : int32_t
+{
+  POINT = 1,   ///< The force frame's y-axis points from the TCP towards the task frame's origin.
+  FRAME = 2,   ///< The force frame is the task frame.
+  MOTION = 3,  ///< The force frame's x-axis is the TCP velocity projected onto the task frame's x-y plane.
+};
+
+/*!
+ * \brief Statistics about the servo cycles reported by the robot.
+ *
+ * While servoing, the URScript program reports every cycle of its servo thread, including whether
+ * a new setpoint was available in time or the motion had to be extrapolated. Each report is packed
+ * into a single integer, so the cycle counter wraps after 128 cycles and longer gaps are counted
+ * modulo 128.
+ */
+struct ServoTelemetry
+{
+  static const size_t EXTRAPOLATION_BINS = 16;
+  static const size_t INTERVAL_BINS = 16;
+  static const size_t AGE_BINS = 16;
+  constexpr static const std::chrono::microseconds INTERVAL_BIN_WIDTH = std::chrono::microseconds(500);
+  constexpr static const std::chrono::microseconds AGE_BIN_WIDTH = std::chrono::microseconds(1000);
+
+  uint64_t cycles = 0;                          //!< Servo cycles reported by the robot
+  uint64_t misses = 0;                          //!< Cycles without a new setpoint, which were extrapolated
+  uint64_t stale_setpoints = 0;                 //!< Setpoints dropped by the robot for being too old
+  uint64_t lost_reports = 0;                    //!< Cycles that weren't reported, detected by counter gaps
+  uint32_t max_consecutive_extrapolations = 0;  //!< Longest run of extrapolated cycles, at most 63
+
+  //! Age of the setpoint executed in the last reported cycle, measured from sending the setpoint
+  //! until its report arrived back at the host. This includes the return trip of the report, so it
+  //! is an upper bound of the age at execution time. Only measured in
+  //! comm::ControlMode::MODE_SERVOJ_TIMESTAMPED, other modes don't send sequence numbers.
+  std::chrono::microseconds last_setpoint_age = std::chrono::microseconds(0);
+  //! Largest setpoint age seen
+  std::chrono::microseconds max_setpoint_age = std::chrono::microseconds(0);
+
+  //! Number of cycles by their count of consecutive extrapolations, the last bin collects all
+  //! larger counts
+  std::array<uint64_t, EXTRAPOLATION_BINS> extrapolation_histogram{};
+  //! Time between consecutive reports arriving at the host in bins of INTERVAL_BIN_WIDTH, the last
+  //! bin collects all larger intervals
+  std::array<uint64_t, INTERVAL_BINS> interval_histogram{};
+  //! Setpoint age per cycle in bins of AGE_BIN_WIDTH, the last bin collects all larger ages
+  std::array<uint64_t, AGE_BINS> setpoint_age_histogram{};
+};
+
 /*!
  * \brief The ReverseInterface class handles communication to the robot. It starts a server and
  * waits for the robot to connect via its URCaps program.
@@ -59,6 +114,9 @@ class ReverseInterface
 {
 public:
   static const int32_t MULT_JOINTSTATE = 1000000;
+  static const int32_t MULT_STAMP = 1000000;
+  //! Time the URScript program waits for a command before it counts down its keepalive
+  constexpr static const std::chrono::milliseconds ROBOT_READ_TIMEOUT = std::chrono::milliseconds(20);
 
   ReverseInterface() = delete;
   /*!
@@ -77,14 +135,47 @@ public:
   /*!
    * \brief Writes needed information to the robot to be read by the URCaps program.
    *
+   * Commands in comm::ControlMode::MODE_SERVOJ_TIMESTAMPED are followed by a sequence number and
+   * the time they were sent. The robot uses them to drop stale setpoints and echoes the sequence
+   * number back to measure the setpoint age, see ServoTelemetry. Other modes don't carry them, so
+   * their frames keep the original layout.
+   *
+   * The command is patched into a persistent, pre-encoded frame and sent without blocking. If the
+   * socket's send buffer is full, the command is dropped and counted as back-pressure. If only a
+   * part of the frame could be sent, this waits at most ROBOT_READ_TIMEOUT for the rest to be sent,
+   * so the robot receives the whole frame. A rest that can't be sent in time is sent first on the
+   * next call, before the new command.
+   *
    * \param positions A vector of joint targets for the robot
    * \param control_mode Control mode assigned to this command. See documentation of comm::ControlMode
    * for details on possible values.
    *
-   * \returns True, if the write was performed successfully, false otherwise.
+   * \returns True, if the whole command was sent, false if it was dropped or not completed due to
+   * back-pressure or the write failed.
    */
   virtual bool write(const vector6d_t* positions, const comm::ControlMode control_mode = comm::ControlMode::MODE_IDLE);
 
+  /*!
+   * \brief Writes a force mode command to the robot. All parameters are sent with every command, so
+   * they can change in every cycle.
+   *
+   * The command is sent like the ones of write(), with the force mode parameters appended to the
+   * frame. Calling write() with comm::ControlMode::MODE_FORCE afterwards only updates the wrench and
+   * keeps the last parameters. Until this has been called, all axes are non-compliant.
+   *
+   * \param wrench Forces and torques the robot applies in compliant axes, velocity limits are given
+   * by \p limits for non-compliant axes
+   * \param selection 1 for compliant axes, 0 for non-compliant axes
+   * \param limits Maximum TCP speeds for compliant axes, maximum deviations for non-compliant axes
+   * \param task_frame Pose of the task frame relative to the base frame
+   * \param type Type of the force frame
+   *
+   * \returns True, if the whole command was sent, false if it was dropped or not completed due to
+   * back-pressure or the write failed.
+   */
+  bool writeForceCommand(const vector6d_t& wrench, const vector6uint32_t& selection, const vector6d_t& limits,
+                         const vector6d_t& task_frame, const ForceModeType type = ForceModeType::FRAME);
+
   /*!
    * \brief Writes needed information to the robot to be read by the URScript program.
    *
@@ -105,6 +196,57 @@ public:
     keepalive_count_ = count;
   }
 
+  /*!
+   * \brief Configures TCP keepalive and the user timeout for the robot's connection to this
+   * interface. This takes effect on the next connection of the robot.
+   *
+   * \param config Keepalive configuration to use
+   */
+  void setKeepaliveConfig(const comm::KeepaliveConfig& config)
+  {
+    server_.setKeepaliveConfig(config);
+  }
+
+  /*!
+   * \brief Getter for the port the interface's server is bound to.
+   *
+   * \returns The port, which is assigned by the operating system if the interface was created with
+   * port 0
+   */
+  int getPort() const
+  {
+    return server_.getPort();
+  }
+
+  /*!
+   * \brief Number of commands dropped by write() because the socket's send buffer was full.
+   */
+  uint64_t getBackPressureCount() const
+  {
+    return back_pressure_count_;
+  }
+
+  /*!
+   * \brief Get the servo cycle statistics reported by the robot.
+   *
+   * \returns A copy of the current statistics
+   */
+  ServoTelemetry getServoTelemetry() const
+  {
+    std::lock_guard<std::mutex> lk(telemetry_mutex_);
+    return telemetry_;
+  }
+
+  /*!
+   * \brief Resets the servo cycle statistics.
+   */
+  void resetServoTelemetry()
+  {
+    std::lock_guard<std::mutex> lk(telemetry_mutex_);
+    telemetry_ = ServoTelemetry();
+    last_servo_cycle_ = -1;
+  }
+
 protected:
   virtual void connectionCallback(const int filedescriptor);
 
@@ -125,6 +267,76 @@ protected:
 
   std::function<void(bool)> handle_program_state_;
   uint32_t keepalive_count_;
+
+  /*!
+   * \brief Sends the unsent rest of the previous command frame.
+   *
+   * \param blocking Whether to block until the rest has been sent. Otherwise, this waits at most
+   * ROBOT_READ_TIMEOUT, which is as long as the robot waits for the rest of a frame.
+   *
+   * \returns False if the socket failed, true otherwise. Without blocking, bytes that can't be sent
+   * in time stay pending.
+   */
+  bool flushPendingFrame(const bool blocking);
+
+private:
+  // Servo cycle reports are packed into one integer: cycle counter, status, extrapolations, sequence
+  static const size_t TELEMETRY_MESSAGE_SIZE = sizeof(int32_t);
+  static const int32_t TELEMETRY_CYCLE_RANGE = 128;
+  static const int32_t TELEMETRY_SEQUENCE_RANGE = 65536;
+  static const size_t FRAME_LENGTH = 8;
+  // Appended to timestamped frames: sequence number and send time
+  static const size_t STAMP_PAYLOAD_LENGTH = 2;
+  // Appended to force mode frames: task frame, selection vector, limits, type
+  static const size_t FORCE_PAYLOAD_LENGTH = 6 + 6 + 6 + 1;
+  static const size_t SEQUENCE_HISTORY = 256;
+
+  // Setpoint status reported by the robot for each servo cycle
+  static const int32_t SETPOINT_NEW = 0;
+  static const int32_t SETPOINT_EXTRAPOLATED = 1;
+  static const int32_t SETPOINT_STALE = 2;
+
+  // Written by the sending thread and read by the server thread without locking. The sequence
+  // number is cleared while the time is updated, so readers can detect a concurrent update.
+  struct SentSetpoint
+  {
+    std::atomic<int32_t> sequence{ 0 };
+    std::atomic<int64_t> time{ 0 };  // steady clock, in nanoseconds since its epoch
+  };
+
+  void handleServoCycle(const int32_t cycle, const int32_t status, const int32_t extrapolations,
+                        const int32_t sequence);
+
+  /*!
+   * \brief Encodes a command into the frame buffer.
+   *
+   * \returns Length of the frame including the payload of the control mode
+   */
+  size_t encodeFrame(const vector6d_t* positions, const comm::ControlMode control_mode);
+  bool sendFrame(const size_t length);
+
+  uint8_t message_buffer_[TELEMETRY_MESSAGE_SIZE];
+  size_t message_fill_;
+
+  mutable std::mutex telemetry_mutex_;
+  ServoTelemetry telemetry_;
+  int32_t last_servo_cycle_;
+  std::chrono::steady_clock::time_point last_report_;
+
+  // Command frame in network byte order: keepalive, 6 values, control mode and the payload of the
+  // control mode, if it has one
+  int32_t frame_[FRAME_LENGTH + std::max(STAMP_PAYLOAD_LENGTH, FORCE_PAYLOAD_LENGTH)];
+  // Last force mode parameters in network byte order, repeated with every force mode frame
+  int32_t force_payload_[FORCE_PAYLOAD_LENGTH];
+  size_t frame_size_;
+  size_t frame_pending_;
+  uint32_t frame_keepalive_;
+  comm::ControlMode frame_mode_;
+  int32_t sequence_;
+  std::chrono::steady_clock::time_point connection_time_;
+  std::array<SentSetpoint, SEQUENCE_HISTORY> sent_setpoints_;
+  std::mutex write_mutex_;
+  std::atomic<uint64_t> back_pressure_count_;
 };
 
 }  // namespace control
@@ -0,0 +1,100 @@
+// this is for emacs file handling -*- mode: c++; indent-tabs-mode: nil -*-
+
+// -- BEGIN LICENSE BLOCK ----------------------------------------------
+// Copyright 2026 Universal Robots A/S
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -- END LICENSE BLOCK ------------------------------------------------
+
+//----------------------------------------------------------------------
+/*!\file
+ *
+ * \date    2026-10-19
+ *
+ */
+//----------------------------------------------------------------------
+
+
+#ifndef UR_CLIENT_LIBRARY_SETPOINT_MAILBOX_H_INCLUDED
+#define UR_CLIENT_LIBRARY_SETPOINT_MAILBOX_H_INCLUDED
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace urcl
+{
+namespace control
+{
+/*!
+ * \brief Lock-free single-slot mailbox passing the newest value from one writer to one reader.
+ *
+ * The mailbox is a triple buffer: the writer and the reader each own one slot, the third one is
+ * exchanged atomically. Neither side ever blocks or waits for the other, and the reader always gets
+ * the most recently published value. Values published in between two fetches are overwritten.
+ *
+ * @tparam T Type of the values, should be cheap to copy
+ */
+template <typename T>
+class SetpointMailbox
+{
+public:
+  SetpointMailbox() : shared_(1), back_(0), front_(2)
+  {
+  }
+  virtual ~SetpointMailbox() = default;
+
+  /*!
+   * \brief Publishes a new value. Must only be called from a single writer thread.
+   *
+   * \param value Value to publish
+   */
+  void publish(const T& value)
+  {
+    slots_[back_] = value;
+    back_ = shared_.exchange(back_ | FRESH, std::memory_order_acq_rel) & INDEX_MASK;
+  }
+
+  /*!
+   * \brief Fetches the newest value, if one was published since the last fetch. Must only be called
+   * from a single reader thread.
+   *
+   * \param value Receives the newest value
+   *
+   * \returns True if a new value was fetched, false if nothing was published since the last fetch
+   */
+  bool fetch(T& value)
+  {
+    if (!(shared_.load(std::memory_order_acquire) & FRESH))
+    {
+      return false;
+    }
+    front_ = shared_.exchange(front_, std::memory_order_acq_rel) & INDEX_MASK;
+    value = slots_[front_];
+    return true;
+  }
+
+private:
+  static const uint8_t INDEX_MASK = 0x3;
+  static const uint8_t FRESH = 0x4;
+
+  std::array<T, 3> slots_;
+  std::atomic<uint8_t> shared_;
+  uint8_t back_;
+  uint8_t front_;
+};
+
+}  // namespace control
+}  // namespace urcl
+
+#endif  // UR_CLIENT_LIBRARY_SETPOINT_MAILBOX_H_INCLUDED
@@ -0,0 +1,172 @@
+// this is for emacs file handling -*- mode: c++; indent-tabs-mode: nil -*-
+
+// -- BEGIN LICENSE BLOCK ----------------------------------------------
+// Copyright 2026 Universal Robots A/S
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -- END LICENSE BLOCK ------------------------------------------------
+
+//----------------------------------------------------------------------
+/*!\file
+ *
+ * \date    2026-10-19
+ *
+ */
+//----------------------------------------------------------------------
+
+
+#ifndef UR_CLIENT_LIBRARY_SETPOINT_SENDER_H_INCLUDED
+#define UR_CLIENT_LIBRARY_SETPOINT_SENDER_H_INCLUDED
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "ur_client_library/comm/control_mode.h"
+#include "ur_client_library/control/reverse_interface.h"
+#include "ur_client_library/control/setpoint_mailbox.h"
+#include "ur_client_library/types.h"
+
+namespace urcl
+{
+namespace control
+{
+/*!
+ * \brief Real-time settings of the setpoint sender thread.
+ *
+ * Both settings reach beyond the sender thread: Locking memory applies to the whole process and
+ * stays in effect after the sender stopped. A SCHED_FIFO thread preempts every normal thread on its
+ * CPU, including other processes. The default priority stays below the kernel's threaded interrupt
+ * handlers (priority 50 on PREEMPT_RT), which deliver the robot's packages.
+ */
+struct RealtimeConfig
+{
+  int priority = 40;         //!< SCHED_FIFO priority, -1 for the maximum priority, 0 to keep the default scheduling
+  int cpu = -1;              //!< CPU to pin the thread to, -1 to not pin it
+  bool lock_memory = false;  //!< Lock the memory of the whole process to prevent page faults
+};
+
+/*!
+ * \brief Sends setpoints to the robot from a dedicated real-time thread.
+ *
+ * Setpoints are published into a lock-free mailbox from any single thread. The sender thread wakes
+ * up once per robot cycle and transmits the newest setpoint through the ReverseInterface, so the
+ * socket is only ever written from one thread and every setpoint is sent exactly once.
+ *
+ * If no new setpoint arrives, nothing is sent and the robot extrapolates as usual. After
+ * \p keepalive_cycles cycles without a new setpoint, a keepalive-only frame
+ * (comm::ControlMode::MODE_KEEPALIVE) is sent, so the robot doesn't stop the program. It neither
+ * changes the control mode nor re-arms the last setpoint.
+ *
+ * Instead of the sender's own thread, the cycles can be driven by a PhaseLockedScheduler, which
+ * aligns sending with the robot's cycle:
+ * \code
+ * scheduler.start([&sender]() { sender.sendCycle(); });
+ * \endcode
+ *
+ * While the sender runs, the ReverseInterface must not be written from any other thread.
+ */
+class SetpointSender
+{
+public:
+  SetpointSender() = delete;
+  /*!
+   * \brief Creates a new SetpointSender.
+   *
+   * \param reverse_interface Interface to send the setpoints through
+   * \param period Duration of a robot cycle
+   * \param keepalive_cycles Cycles without a new setpoint after which a keepalive is sent. 0 derives
+   * them from ReverseInterface::ROBOT_READ_TIMEOUT, so a keepalive is sent every half read timeout.
+   */
+  SetpointSender(ReverseInterface& reverse_interface, const std::chrono::nanoseconds period,
+                 const uint32_t keepalive_cycles = 0);
+  virtual ~SetpointSender();
+
+  /*!
+   * \brief Starts the sender thread.
+   *
+   * \param config Real-time settings applied to the sender thread
+   */
+  void start(const RealtimeConfig& config = RealtimeConfig());
+
+  /*!
+   * \brief Stops the sender thread.
+   */
+  void stop();
+
+  /*!
+   * \brief Runs a single cycle: sends the newest setpoint if there is one, otherwise a keepalive
+   * if it is due. This is for driving the sender from an external loop instead of start(), it has
+   * to be called once per robot cycle from a single thread.
+   */
+  void sendCycle();
+
+  /*!
+   * \brief Publishes a new setpoint. Must only be called from a single thread. Never blocks.
+   *
+   * \param values Joint positions, velocities or pose, depending on the control mode
+   * \param control_mode Control mode of the setpoint
+   */
+  void publish(const vector6d_t& values, const comm::ControlMode control_mode);
+
+  /*!
+   * \brief Number of setpoints sent to the robot.
+   */
+  uint64_t getSentCount() const
+  {
+    return sent_;
+  }
+
+  /*!
+   * \brief Number of keepalives sent because no new setpoint arrived in time.
+   */
+  uint64_t getKeepaliveCount() const
+  {
+    return keepalives_;
+  }
+
+  /*!
+   * \brief Number of cycles without a new setpoint after which a keepalive is sent.
+   */
+  uint32_t getKeepaliveCycles() const
+  {
+    return keepalive_cycles_;
+  }
+
+private:
+  struct Setpoint
+  {
+    vector6d_t values;
+    comm::ControlMode mode;
+  };
+
+  void run(const RealtimeConfig config);
+  void applyRealtimeConfig(const RealtimeConfig& config);
+
+  ReverseInterface& reverse_interface_;
+  std::chrono::nanoseconds period_;
+  uint32_t keepalive_cycles_;
+
+  SetpointMailbox<Setpoint> mailbox_;
+  Setpoint setpoint_;
+  uint32_t cycles_without_setpoint_;
+  std::thread thread_;
+  std::atomic<bool> running_;
+  std::atomic<uint64_t> sent_;
+  std::atomic<uint64_t> keepalives_;
+};
+
+}  // namespace control
+}  // namespace urcl
+
+#endif  // UR_CLIENT_LIBRARY_SETPOINT_SENDER_H_INCLUDED
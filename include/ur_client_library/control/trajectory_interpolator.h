@@ -0,0 +1,147 @@
+// this is for emacs file handling -*- mode: c++; indent-tabs-mode: nil -*-
+
+// -- BEGIN LICENSE BLOCK ----------------------------------------------
+// Copyright 2026 Universal Robots A/S
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -- END LICENSE BLOCK ------------------------------------------------
+
+//----------------------------------------------------------------------
+/*!\file
+ *
+ * \date    2026-10-19
+ *
+ */
+//----------------------------------------------------------------------
+
+
+#ifndef UR_CLIENT_LIBRARY_TRAJECTORY_INTERPOLATOR_H_INCLUDED
+#define UR_CLIENT_LIBRARY_TRAJECTORY_INTERPOLATOR_H_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "ur_client_library/types.h"
+
+namespace urcl
+{
+namespace control
+{
+/*!
+ * \brief Streaming interpolator turning sparse waypoints into servo setpoints.
+ *
+ * Waypoints can be added at any rate, e.g. from a planner running at 50-100 Hz. Between waypoints
+ * the motion is interpolated by cubic Hermite splines, whose tangents are estimated from the
+ * neighboring waypoints (Catmull-Rom). The trajectory ends at rest in the last known waypoint, so
+ * for a smooth motion the planner should stay at least one waypoint ahead of the robot.
+ *
+ * Setpoints are produced at a fixed sample period by next(), which is meant to be called once per
+ * received RTDE package, e.g. with a period of 1 / UrDriver::getControlFrequency(). Waypoints that
+ * have been passed are discarded, so memory is bounded by the number of waypoints ahead.
+ */
+class TrajectoryInterpolator
+{
+public:
+  TrajectoryInterpolator() = delete;
+  /*!
+   * \brief Creates a new TrajectoryInterpolator.
+   *
+   * \param sample_period Time between two setpoints produced by next() in seconds
+   * \param max_waypoints Maximum number of waypoints kept at once
+   */
+  TrajectoryInterpolator(const double sample_period, const size_t max_waypoints = 64);
+  virtual ~TrajectoryInterpolator() = default;
+
+  /*!
+   * \brief Appends a waypoint to the trajectory.
+   *
+   * \param position Joint positions at the waypoint
+   * \param time Time of the waypoint in seconds, relative to the first call of next(). Has to be
+   * larger than the time of the previous waypoint.
+   *
+   * \returns False if the waypoint is not later than the previous one or the buffer is full, true
+   * otherwise.
+   */
+  bool addWaypoint(const vector6d_t& position, const double time);
+
+  /*!
+   * \brief Advances the interpolator by one sample period and computes the setpoint.
+   *
+   * \param setpoint Interpolated joint positions
+   *
+   * \returns False if no waypoint is known or the trajectory ran out of waypoints, in which case the
+   * last waypoint is held. True otherwise.
+   */
+  bool next(vector6d_t& setpoint);
+
+  /*!
+   * \brief Evaluates the trajectory at the given time without advancing the interpolator.
+   *
+   * \param time Time in seconds, relative to the first call of next()
+   * \param setpoint Interpolated joint positions
+   *
+   * \returns False if no waypoint is known or the time is after the last waypoint, true otherwise.
+   */
+  bool evaluate(const double time, vector6d_t& setpoint) const;
+
+  /*!
+   * \brief Removes all waypoints and resets the time to 0.
+   */
+  void reset();
+
+  /*!
+   * \brief Current time of the interpolator, i.e. the time of the last setpoint returned by next().
+   */
+  double getTime() const
+  {
+    return time_;
+  }
+
+  /*!
+   * \brief Number of waypoints currently stored.
+   */
+  size_t getNumWaypoints() const
+  {
+    return size_;
+  }
+
+private:
+  struct Waypoint
+  {
+    vector6d_t position;
+    double time;
+  };
+
+  const Waypoint& at(const size_t index) const
+  {
+    return waypoints_[(head_ + index) % waypoints_.size()];
+  }
+  void tangent(const size_t index, vector6d_t& tangent) const;
+  void dropPassedWaypoints();
+
+  double sample_period_;
+  double time_;
+  bool started_;
+  uint64_t steps_;
+
+  // Ring buffer, so adding waypoints doesn't allocate
+  std::vector<Waypoint> waypoints_;
+  size_t head_;
+  size_t size_;
+};
+
+}  // namespace control
+}  // namespace urcl
+
+#endif  // UR_CLIENT_LIBRARY_TRAJECTORY_INTERPOLATOR_H_INCLUDED
@@ -34,6 +34,10 @@
 #include "ur_client_library/types.h"
 #include "ur_client_library/log.h"
 
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
 namespace urcl
 {
 namespace control
@@ -49,6 +53,27 @@ enum class TrajectoryResult : int32_t
   TRAJECTORY_RESULT_FAILURE = 2    ///< Aborted due to error during execution
 };
 
+/*!
+ * \brief Types of the messages the robot sends on the trajectory socket. Each message consists of
+ * the type followed by a value.
+ */
+enum class TrajectoryMessageType : int32_t
+{
+  TRAJECTORY_MESSAGE_RESULT = 0,   ///< Trajectory execution ended, the value is a TrajectoryResult
+  TRAJECTORY_MESSAGE_PROGRESS = 1  ///< The value is the number of points the robot consumed so far
+};
+
+/*!
+ * \brief A single point of a trajectory, as used for uploading trajectories given as an array of
+ * points.
+ */
+struct TrajectoryPoint
+{
+  vector6d_t positions{};      ///< Joint or cartesian target
+  float goal_time{ 0.0f };     ///< Time to reach the target
+  float blend_radius{ 0.0f };  ///< Radius for blending into the next point, 0 for no blending
+};
+
 /*!
  * \brief The TrajectoryPointInterface class handles trajectory forwarding to the robot. Full
  * trajectories are forwarded to the robot controller and are executed there.
@@ -86,11 +111,92 @@ public:
   bool writeTrajectoryPoint(const vector6d_t* positions, const float goal_time, const float blend_radius,
                             const bool cartesian);
 
+  /*!
+   * \brief Writes a batch of trajectory points to the robot with as few socket writes as possible.
+   *
+   * All points are encoded into one contiguous buffer, which is then sent at once. The points are
+   * given as separate arrays of equal length, so that they can be passed without copying them into
+   * an intermediate point structure.
+   *
+   * \param positions Array of joint or cartesian targets, one per point
+   * \param goal_times Array of goal times to reach each target
+   * \param blend_radii Array of blend radii, one per point. May be nullptr to use no blending.
+   * \param num_points Number of points in the arrays
+   * \param cartesian True, if the points are specified in cartesian space, false if in joint space
+   *
+   * \returns True, if the write was performed successfully, false otherwise.
+   */
+  bool writeTrajectoryPoints(const vector6d_t* positions, const float* goal_times, const float* blend_radii,
+                             const size_t num_points, const bool cartesian);
+
+  /*!
+   * \brief Writes a batch of trajectory points to the robot with as few socket writes as possible.
+   *
+   * Same as the overload taking separate arrays, for trajectories stored as an array of points.
+   *
+   * \param points Array of trajectory points
+   * \param num_points Number of points in the array
+   * \param cartesian True, if the points are specified in cartesian space, false if in joint space
+   *
+   * \returns True, if the write was performed successfully, false otherwise.
+   */
+  bool writeTrajectoryPoints(const TrajectoryPoint* points, const size_t num_points, const bool cartesian);
+
+  /*!
+   * \brief Streams a trajectory to the robot while keeping a bounded number of points in flight.
+   *
+   * Points are only sent as long as the number of points sent but not yet consumed by the robot
+   * stays below \p window. The robot reports consumed points on the trajectory socket, so this can
+   * be used for trajectories of arbitrary length without flooding the robot's socket buffer. The
+   * trajectory has to be started with a TrajectoryControlMessage::TRAJECTORY_START announcing
+   * \p num_points before. Call resetProgress() before sending the start message, so that progress
+   * the robot reports right after the start is not lost.
+   *
+   * This call blocks until all points have been sent, the trajectory ended (e.g. because it was
+   * canceled) or the robot disconnected.
+   *
+   * \param positions Array of joint or cartesian targets, one per point
+   * \param goal_times Array of goal times to reach each target
+   * \param blend_radii Array of blend radii, one per point. May be nullptr to use no blending.
+   * \param num_points Number of points in the arrays
+   * \param cartesian True, if the points are specified in cartesian space, false if in joint space
+   * \param window Maximum number of points sent but not yet consumed by the robot
+   *
+   * \returns True, if all points were sent, false otherwise.
+   */
+  bool streamTrajectory(const vector6d_t* positions, const float* goal_times, const float* blend_radii,
+                        const size_t num_points, const bool cartesian, const size_t window);
+
+  /*!
+   * \brief Forgets the progress of the previous trajectory. This has to be called before a new
+   * trajectory is started with TrajectoryControlMessage::TRAJECTORY_START.
+   */
+  void resetProgress();
+
+  /*!
+   * \brief Number of points of the current trajectory the robot has consumed so far.
+   */
+  uint32_t getConsumedPoints() const
+  {
+    return consumed_points_;
+  }
+
   void setTrajectoryEndCallback(std::function<void(TrajectoryResult)> callback)
   {
     handle_trajectory_end_ = callback;
   }
 
+  /*!
+   * \brief Sets a callback receiving the number of consumed points whenever the robot reports
+   * progress on the current trajectory.
+   *
+   * \param callback Callback function
+   */
+  void setTrajectoryProgressCallback(std::function<void(uint32_t)> callback)
+  {
+    handle_trajectory_progress_ = callback;
+  }
+
 protected:
   virtual void connectionCallback(const int filedescriptor) override;
 
@@ -99,7 +205,25 @@ protected:
   virtual void messageCallback(const int filedescriptor, char* buffer, int nbytesrecv) override;
 
 private:
+  static const size_t MESSAGE_LENGTH = 9;
+  static const size_t ROBOT_MESSAGE_SIZE = 2 * sizeof(int32_t);
+
+  void handleRobotMessage(const TrajectoryMessageType type, const int32_t value);
+  static void encodePoint(int32_t* buffer, const vector6d_t& positions, const float goal_time, const float blend_radius,
+                          const int32_t point_type);
+  bool sendBatch();
+
   std::function<void(TrajectoryResult)> handle_trajectory_end_;
+  std::function<void(uint32_t)> handle_trajectory_progress_;
+  std::vector<int32_t> batch_buffer_;
+
+  uint8_t message_buffer_[ROBOT_MESSAGE_SIZE];
+  size_t message_fill_;
+
+  std::mutex progress_mutex_;
+  std::condition_variable progress_cv_;
+  std::atomic<uint32_t> consumed_points_;
+  std::atomic<bool> trajectory_ended_;
 };
 
 }  // namespace control
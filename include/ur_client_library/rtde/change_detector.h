@@ -0,0 +1,170 @@
+// this is for emacs file handling -*- mode: c++; indent-tabs-mode: nil -*-
+
+// -- BEGIN LICENSE BLOCK ----------------------------------------------
+// Copyright 2026 Universal Robots A/S
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -- END LICENSE BLOCK ------------------------------------------------
+
+//----------------------------------------------------------------------
+/*!\file
+ *
+ * \date    2026-10-19
+ *
+ */
+//----------------------------------------------------------------------
+
+
+
+#ifndef UR_CLIENT_LIBRARY_RTDE_CHANGE_DETECTOR_H_INCLUDED
+#define UR_CLIENT_LIBRARY_RTDE_CHANGE_DETECTOR_H_INCLUDED
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ur_client_library/rtde/data_package.h"
+
+namespace urcl
+{
+namespace rtde_interface
+{
+/*!
+ * \brief Detects which fields changed between consecutive RTDE data packages.
+ *
+ * The previous sample is kept in a flat buffer in which every field starts at a 64 bit word
+ * boundary. Each field of a new sample is packed into words and compared against the buffer in a
+ * single pass, which results in a bitmask with one bit per recipe field. For integral fields
+ * (bools, integers and bitmasks such as \p digital_input_bits or \p safety_status_bits) rising and
+ * falling bit edges are reported as well.
+ *
+ * Subscribers register with a field mask and are only called when one of their fields changed.
+ */
+class ChangeDetector
+{
+public:
+  /*!
+   * \brief One bit per recipe field, field i is stored in bit (i % 64) of word (i / 64).
+   */
+  using FieldMask = std::vector<uint64_t>;
+
+  /*!
+   * \brief Bit edges of an integral field between two samples.
+   */
+  struct FieldEdges
+  {
+    size_t field;      //!< Index of the field in the recipe
+    uint64_t rising;   //!< Bits that changed from 0 to 1
+    uint64_t falling;  //!< Bits that changed from 1 to 0
+  };
+
+  using Subscriber = std::function<void(const FieldMask& changed, const std::vector<FieldEdges>& edges)>;
+
+  ChangeDetector() = delete;
+  /*!
+   * \brief Creates a change detector for packages of the given recipe.
+   *
+   * \param recipe Output recipe of the packages that will be passed to update()
+   *
+   * \throws UrException if the recipe contains unknown or string fields.
+   */
+  explicit ChangeDetector(const std::vector<std::string>& recipe);
+  virtual ~ChangeDetector() = default;
+
+  /*!
+   * \brief Gets the index of a field inside the recipe.
+   *
+   * \throws UrException if the field is not part of the recipe.
+   */
+  size_t getFieldIndex(const std::string& field) const;
+
+  /*!
+   * \brief Creates a field mask containing the given fields.
+   *
+   * \throws UrException if a field is not part of the recipe.
+   */
+  FieldMask makeMask(const std::vector<std::string>& fields) const;
+
+  /*!
+   * \brief Registers a subscriber that is called from update() if any field of its mask changed.
+   *
+   * \param mask Fields the subscriber is interested in, as created by makeMask()
+   * \param subscriber Function receiving the changed fields and edges of the whole sample
+   *
+   * \throws UrException if the mask doesn't match the size of the recipe.
+   */
+  void subscribe(const FieldMask& mask, Subscriber subscriber);
+
+  /*!
+   * \brief Compares a package against the previous one and notifies the subscribers.
+   *
+   * The first package only serves as reference and doesn't report any changes. A field missing
+   * from the package keeps its previous value.
+   *
+   * \param package Data package of the recipe given in the constructor
+   *
+   * \returns True if any field changed, false otherwise
+   */
+  bool update(DataPackage& package);
+
+  /*!
+   * \brief Fields that changed during the last update().
+   */
+  const FieldMask& getChangedFields() const
+  {
+    return changed_;
+  }
+
+  /*!
+   * \brief Bit edges of integral fields found during the last update().
+   */
+  const std::vector<FieldEdges>& getEdges() const
+  {
+    return edges_;
+  }
+
+  /*!
+   * \brief Checks whether a field changed during the last update().
+   */
+  bool hasChanged(const std::string& field) const;
+
+private:
+  struct Layout
+  {
+    std::string name;
+    size_t offset;  // in words
+    size_t words;
+    bool integral;
+    size_t type;  // variant index of the field's value
+    bool present;  // whether the field is part of the current package recipe
+    size_t index;  // position of the field in the current package recipe
+  };
+
+  void resolve(const DataPackage& package);
+
+  std::vector<Layout> layout_;
+  std::vector<uint64_t> previous_;
+  bool has_previous_;
+  std::shared_ptr<const std::vector<std::string>> recipe_;
+
+  FieldMask changed_;
+  std::vector<FieldEdges> edges_;
+  std::vector<std::pair<FieldMask, Subscriber>> subscribers_;
+};
+
+}  // namespace rtde_interface
+}  // namespace urcl
+
+#endif  // UR_CLIENT_LIBRARY_RTDE_CHANGE_DETECTOR_H_INCLUDED
@@ -0,0 +1,173 @@
+// this is for emacs file handling -*- mode: c++; indent-tabs-mode: nil -*-
+
+// -- BEGIN LICENSE BLOCK ----------------------------------------------
+// Copyright 2026 Universal Robots A/S
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -- END LICENSE BLOCK ------------------------------------------------
+
+//----------------------------------------------------------------------
+/*!\file
+ *
+ * \date    2026-10-19
+ *
+ */
+//----------------------------------------------------------------------
+
+
+
+#ifndef UR_CLIENT_LIBRARY_RTDE_CLOCK_ESTIMATOR_H_INCLUDED
+#define UR_CLIENT_LIBRARY_RTDE_CLOCK_ESTIMATOR_H_INCLUDED
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "ur_client_library/rtde/data_package.h"
+
+namespace urcl
+{
+namespace rtde_interface
+{
+/*!
+ * \brief Estimates the relation between the robot controller's clock and the host's monotonic
+ * clock from RTDE data packages.
+ *
+ * Each package provides a pair of the controller's \p timestamp and the host time it was received.
+ * The difference of both is the clock offset plus the network and processing delay, which is
+ * always positive. Per window of packages only the sample with the smallest delay is kept. A line
+ * is fitted through the recent minima, modelling both offset and drift of the robot's clock.
+ *
+ * The minimal one-way delay itself can't be observed, so converted times refer to the earliest
+ * possible arrival of a package on the host. Error bounds are the largest deviation of the kept
+ * minima from the fitted line.
+ *
+ * All methods are thread-safe. Conversions only evaluate the fitted line and are cheap enough to
+ * be used from a control loop.
+ */
+class ClockEstimator
+{
+public:
+  /*!
+   * \brief Creates a new ClockEstimator.
+   *
+   * \param window_size Number of packages per min-delay window, e.g. 50 packages at 500 Hz
+   * \param num_windows Number of window minima the line is fitted through
+   */
+  ClockEstimator(const size_t window_size = 50, const size_t num_windows = 64);
+  virtual ~ClockEstimator() = default;
+
+  /*!
+   * \brief Adds a sample to the estimation.
+   *
+   * \param robot_time Controller timestamp in seconds
+   * \param host_time Host time the sample was received
+   */
+  void update(const double robot_time, const std::chrono::steady_clock::time_point host_time);
+
+  /*!
+   * \brief Adds a data package to the estimation. The package needs to contain the \p timestamp
+   * field. Its kernel receive time is used as the host time, or the current time if the package
+   * has no kernel receive time.
+   *
+   * \param package Received data package
+   *
+   * \returns False if the package doesn't contain a timestamp, true otherwise
+   */
+  bool update(DataPackage& package);
+
+  /*!
+   * \brief Checks whether enough samples have been collected to convert times.
+   */
+  bool isValid() const;
+
+  /*!
+   * \brief Converts a controller timestamp into host time.
+   *
+   * \param robot_time Controller timestamp in seconds
+   * \param host_time Corresponding host time
+   * \param error_bound Estimated maximum error of the conversion
+   *
+   * \returns False if the estimate isn't valid yet, true otherwise
+   */
+  bool robotToHost(const double robot_time, std::chrono::steady_clock::time_point& host_time,
+                   std::chrono::nanoseconds& error_bound) const;
+
+  /*!
+   * \brief Converts a host time into a controller timestamp.
+   *
+   * \param host_time Host time
+   * \param robot_time Corresponding controller timestamp in seconds
+   * \param error_bound Estimated maximum error of the conversion in seconds
+   *
+   * \returns False if the estimate isn't valid yet, true otherwise
+   */
+  bool hostToRobot(const std::chrono::steady_clock::time_point host_time, double& robot_time,
+                   double& error_bound) const;
+
+  /*!
+   * \brief Estimated drift of the robot's clock relative to the host's clock, e.g. 1e-5 if the
+   * host's clock runs 10 ppm faster.
+   */
+  double getDrift() const;
+
+  /*!
+   * \brief Removes all samples, e.g. after the controller restarted and its timestamp was reset.
+   */
+  void reset();
+
+private:
+  struct Sample
+  {
+    double robot_time;
+    double offset;  // host time - robot time, in seconds
+  };
+
+  void fit();
+  double hostSeconds(const std::chrono::steady_clock::time_point host_time) const
+  {
+    return std::chrono::duration<double>(host_time - host_reference_).count();
+  }
+
+  size_t window_size_;
+  size_t num_windows_;
+
+  mutable std::mutex mutex_;
+  std::shared_ptr<const std::vector<std::string>> recipe_;
+  bool has_timestamp_;
+  size_t timestamp_index_;
+  bool has_reference_;
+  std::chrono::steady_clock::time_point host_reference_;
+
+  Sample window_min_;
+  size_t window_count_;
+  double last_robot_time_;
+
+  std::vector<Sample> minima_;
+  size_t next_minimum_;
+
+  // Fitted line: offset = intercept_ + slope_ * (robot_time - robot_reference_)
+  bool valid_;
+  double robot_reference_;
+  double intercept_;
+  double slope_;
+  double error_bound_;
+};
+
+}  // namespace rtde_interface
+}  // namespace urcl
+
+#endif  // UR_CLIENT_LIBRARY_RTDE_CLOCK_ESTIMATOR_H_INCLUDED
@@ -0,0 +1,139 @@
+// this is for emacs file handling -*- mode: c++; indent-tabs-mode: nil -*-
+
+// -- BEGIN LICENSE BLOCK ----------------------------------------------
+// Copyright 2026 Universal Robots A/S
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -- END LICENSE BLOCK ------------------------------------------------
+
+//----------------------------------------------------------------------
+/*!\file
+ *
+ * \date    2026-10-19
+ *
+ */
+//----------------------------------------------------------------------
+
+
+#ifndef UR_CLIENT_LIBRARY_RTDE_CONTROL_CHANNEL_H_INCLUDED
+#define UR_CLIENT_LIBRARY_RTDE_CONTROL_CHANNEL_H_INCLUDED
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include "ur_client_library/rtde/rtde_package.h"
+
+namespace urcl
+{
+namespace rtde_interface
+{
+/*!
+ * \brief Request/response channel for RTDE control messages.
+ *
+ * The channel is installed as product router of the RTDE pipeline. Replies to control requests
+ * (protocol version, urcontrol version, recipe setup, start and pause) are taken out of the
+ * package stream and handed to whoever is waiting for them, while data packages continue to the
+ * pipeline's queue untouched. Text messages sent by the robot are logged.
+ *
+ * Replies of the same type are matched to pending requests in the order the requests were made. A
+ * request whose wait timed out stays pending, so a late reply is consumed by the request it
+ * belongs to instead of being handed to a later one.
+ */
+class ControlChannel
+{
+public:
+  /*!
+   * \brief Handle of a pending request returned by expectReply().
+   */
+  struct Reply
+  {
+    PackageType type = PackageType::RTDE_DATA_PACKAGE;  ///< Package type of the expected reply
+    uint64_t id = 0;                                    ///< Identifies the request within the channel
+    std::future<std::unique_ptr<RTDEPackage>> future;   ///< Holds the reply once it has been received
+
+    /*!
+     * \brief Returns whether the handle refers to a registered request.
+     */
+    bool valid() const
+    {
+      return future.valid();
+    }
+  };
+
+  ControlChannel() = default;
+  virtual ~ControlChannel() = default;
+
+  /*!
+   * \brief Registers a pending request. This has to be called before the request is sent to the
+   * robot.
+   *
+   * \param type Package type of the reply to wait for
+   *
+   * \returns A handle that will hold the reply once it has been received
+   */
+  Reply expectReply(const PackageType type);
+
+  /*!
+   * \brief Waits for a reply registered with expectReply().
+   *
+   * \param reply The handle returned by expectReply()
+   * \param timeout Maximum time to wait for the reply
+   *
+   * \returns The reply or a nullptr, if no reply was received in time or the request was canceled
+   */
+  static std::unique_ptr<RTDEPackage> waitForReply(Reply& reply, const std::chrono::milliseconds timeout);
+
+  /*!
+   * \brief Cancels a pending request because sending it failed, so no reply will arrive for it.
+   *
+   * Requests whose reply timed out must not be canceled, as the robot will still answer them.
+   *
+   * \param reply The handle returned by expectReply()
+   */
+  void cancel(const Reply& reply);
+
+  /*!
+   * \brief Cancels all pending requests.
+   */
+  void clear();
+
+  /*!
+   * \brief Takes a package out of the package stream if it is a control message.
+   *
+   * \param package Package received from the robot
+   *
+   * \returns True if the package has been consumed by the channel, false if it should be passed on
+   */
+  bool route(std::unique_ptr<RTDEPackage>& package);
+
+private:
+  struct PendingRequest
+  {
+    uint64_t id;
+    std::promise<std::unique_ptr<RTDEPackage>> promise;
+  };
+
+  std::mutex mutex_;
+  uint64_t next_id_ = 0;
+  std::map<PackageType, std::deque<PendingRequest>> pending_;
+};
+
+}  // namespace rtde_interface
+}  // namespace urcl
+
+#endif  // UR_CLIENT_LIBRARY_RTDE_CONTROL_CHANNEL_H_INCLUDED
@@ -29,6 +29,8 @@
 #ifndef UR_CLIENT_LIBRARY_DATA_PACKAGE_H_INCLUDED
 #define UR_CLIENT_LIBRARY_DATA_PACKAGE_H_INCLUDED
 
+#include <memory>
+#include <type_traits>
 #include <unordered_map>
 #include <variant>
 #include <vector>
@@ -65,9 +67,15 @@ public:
 
   DataPackage() = delete;
 
-  DataPackage(const DataPackage& other) : DataPackage(other.recipe_)
+  DataPackage(const DataPackage& other)
+    : RTDEPackage(PackageType::RTDE_DATA_PACKAGE)
+    , recipe_id_(other.recipe_id_)
+    , data_(other.data_)
+    , known_(other.known_)
+    , filled_(other.filled_)
+    , recipe_(other.recipe_)
   {
-    this->data_ = other.data_;
+    this->setReceiveTimestamps(other.getKernelReceiveTime(), other.getParsedTime());
   }
 
   /*!
@@ -75,9 +83,21 @@ public:
    *
    * \param recipe The used recipe
    */
-  DataPackage(const std::vector<std::string>& recipe) : RTDEPackage(PackageType::RTDE_DATA_PACKAGE), recipe_(recipe)
+  DataPackage(const std::vector<std::string>& recipe)
+    : DataPackage(std::make_shared<const std::vector<std::string>>(recipe))
   {
   }
+
+  /*!
+   * \brief Creates a new DataPackage object sharing its recipe with other packages.
+   *
+   * Packages sharing a recipe store their fields at the same positions, so consumers only have to
+   * look up a field once using findField() and can then read it from every package using
+   * getDataAt().
+   *
+   * \param recipe The used recipe
+   */
+  DataPackage(std::shared_ptr<const std::vector<std::string>> recipe);
   virtual ~DataPackage() = default;
 
   /*!
@@ -123,9 +143,14 @@ public:
   template <typename T>
   bool getData(const std::string& name, T& val)
   {
-    if (data_.find(name) != data_.end())
+    size_t index;
+    if (filled_ && findField(name, index))
     {
-      val = std::get<T>(data_[name]);
+      val = std::get<T>(data_[index]);
+    }
+    else if constexpr (std::is_same<T, bool>::value)
+    {
+      return getPackedBit(name, val);
     }
     else
     {
@@ -134,6 +159,68 @@ public:
     return true;
   }
 
+  /*!
+   * \brief Get a data field from the DataPackage without knowing its type.
+   *
+   * \param name The string identifier for the data field as used in the documentation.
+   * \param val Target variable holding the field's value afterwards
+   *
+   * \returns True on success, false if the field cannot be found inside the package.
+   */
+  bool getData(const std::string& name, _rtde_type_variant& val)
+  {
+    size_t index;
+    if (!filled_ || !findField(name, index))
+    {
+      bool bit;
+      if (!getPackedBit(name, bit))
+      {
+        return false;
+      }
+      val = bit;
+      return true;
+    }
+    val = data_[index];
+    return true;
+  }
+
+  /*!
+   * \brief Looks up the position of a field in the package's recipe.
+   *
+   * \param name The string identifier for the data field as used in the documentation.
+   * \param index Position of the field afterwards, to be used with getDataAt()
+   *
+   * \returns True on success, false if the field is not part of the recipe or unknown.
+   */
+  bool findField(const std::string& name, size_t& index) const;
+
+  /*!
+   * \brief Get a data field by its position in the recipe without copying it.
+   *
+   * \param index Position of the field as returned by findField()
+   *
+   * \returns The field's value or nullptr if the package holds no value at that position.
+   */
+  const _rtde_type_variant* getDataAt(const size_t index) const
+  {
+    if (!filled_ || index >= data_.size() || !known_[index])
+    {
+      return nullptr;
+    }
+    return &data_[index];
+  }
+
+  /*!
+   * \brief Getter for the recipe. Packages created by the same parser share the recipe object
+   * until the parser's recipe is changed, so it can be used to detect a change of the layout.
+   *
+   * \returns The recipe of the package
+   */
+  const std::shared_ptr<const std::vector<std::string>>& getRecipe() const
+  {
+    return recipe_;
+  }
+
   /*!
    * \brief Get a data field from the DataPackage as bitset
    *
@@ -149,9 +236,10 @@ public:
   {
     static_assert(sizeof(T) * 8 >= N, "Bitset is too large for underlying variable");
 
-    if (data_.find(name) != data_.end())
+    size_t index;
+    if (filled_ && findField(name, index))
     {
-      val = std::bitset<N>(std::get<T>(data_[name]));
+      val = std::bitset<N>(std::get<T>(data_[index]));
     }
     else
     {
@@ -173,9 +261,10 @@ public:
   template <typename T>
   bool setData(const std::string& name, T& val)
   {
-    if (data_.find(name) != data_.end())
+    size_t index;
+    if (filled_ && findField(name, index))
     {
-      data_[name] = val;
+      data_[index] = val;
     }
     else
     {
@@ -194,12 +283,31 @@ public:
     recipe_id_ = recipe_id;
   }
 
+  /*!
+   * \brief Maps an individual output bit register onto the packed word containing it.
+   *
+   * The RTDE interface offers the output bit registers 0 to 63 additionally as the packed words
+   * \p output_bit_registers0_to_31 and \p output_bit_registers32_to_63.
+   *
+   * \param name Name of an individual bit register, e.g. \p output_bit_register_42
+   * \param word Name of the packed word containing the register
+   * \param bit Position of the register inside the packed word
+   *
+   * \returns True if the register is available as part of a packed word, false otherwise
+   */
+  static bool getPackedBitRegister(const std::string& name, std::string& word, size_t& bit);
+
 private:
+  bool getPackedBit(const std::string& name, bool& val) const;
+
   // Const would be better here
   static std::unordered_map<std::string, _rtde_type_variant> g_type_list;
   uint8_t recipe_id_;
-  std::unordered_map<std::string, _rtde_type_variant> data_;
-  std::vector<std::string> recipe_;
+  // Values in the order of the recipe. Fields of unknown type are marked in known_.
+  std::vector<_rtde_type_variant> data_;
+  std::vector<bool> known_;
+  bool filled_;
+  std::shared_ptr<const std::vector<std::string>> recipe_;
 };
 
 }  // namespace rtde_interface
@@ -0,0 +1,146 @@
+// this is for emacs file handling -*- mode: c++; indent-tabs-mode: nil -*-
+
+// -- BEGIN LICENSE BLOCK ----------------------------------------------
+// Copyright 2026 Universal Robots A/S
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -- END LICENSE BLOCK ------------------------------------------------
+
+//----------------------------------------------------------------------
+/*!\file
+ *
+ * \date    2026-10-19
+ *
+ */
+//----------------------------------------------------------------------
+
+
+
+#ifndef UR_CLIENT_LIBRARY_RTDE_EDGE_MONITOR_H_INCLUDED
+#define UR_CLIENT_LIBRARY_RTDE_EDGE_MONITOR_H_INCLUDED
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "ur_client_library/rtde/data_package.h"
+
+namespace urcl
+{
+namespace rtde_interface
+{
+/*!
+ * \brief Calls registered callbacks whenever selected fields of the RTDE data packages change.
+ *
+ * The monitor is evaluated on the producer thread right after a data package has been parsed, i.e.
+ * before the package is queued for the consumer. Callbacks therefore see e.g. a change of
+ * \p safety_status_bits as early as possible, but they block the reception of further packages
+ * while running. They must not allocate, block or take locks shared with the consumer side, and
+ * should return well within the configured time budget. Callbacks exceeding the budget are
+ * counted as overruns.
+ *
+ * Callbacks can be added while packages are processed. A callback added that way is first called
+ * for a change between two packages received after adding it.
+ *
+ * Only scalar fields are supported, as comparing them does not allocate. The position of a watched
+ * field is looked up once for every recipe (see DataPackage::getRecipe()), so processing a package
+ * reads the fields directly.
+ */
+class EdgeMonitor
+{
+public:
+  using Callback = std::function<void(const DataPackage::_rtde_type_variant& previous,
+                                      const DataPackage::_rtde_type_variant& current)>;
+
+  EdgeMonitor() : budget_(std::chrono::microseconds(50)), overruns_(0)
+  {
+  }
+  virtual ~EdgeMonitor() = default;
+
+  /*!
+   * \brief Registers a callback for a field. This must not be called from within a callback.
+   *
+   * \param field Name of the field as used in the output recipe
+   * \param callback Function called with the previous and current value whenever the field changes
+   *
+   * \returns False if the field is unknown or not a scalar, true otherwise
+   */
+  bool addCallback(const std::string& field, Callback callback);
+
+  /*!
+   * \brief Sets the time each callback may take before it is counted as overrun.
+   *
+   * \param budget Time budget per callback invocation
+   */
+  void setBudget(const std::chrono::microseconds budget)
+  {
+    budget_ = budget;
+  }
+
+  /*!
+   * \brief Number of callback invocations that exceeded the time budget.
+   */
+  uint64_t getOverruns() const
+  {
+    return overruns_;
+  }
+
+  /*!
+   * \brief Checks whether any callbacks are registered.
+   */
+  bool empty() const
+  {
+    std::lock_guard<std::mutex> lock(watches_mutex_);
+    return watches_.empty();
+  }
+
+  /*!
+   * \brief Compares the watched fields against their previous values and runs the callbacks of
+   * changed fields.
+   *
+   * \param package Freshly parsed data package
+   */
+  void process(DataPackage& package);
+
+private:
+  struct Watch
+  {
+    std::string field;
+    Callback callback;
+    DataPackage::_rtde_type_variant last;
+    bool has_last;
+    size_t type;       // Alternative of DataPackage::_rtde_type_variant holding the field
+    std::string word;  // Packed word containing the field, if it is an individual bit register
+    size_t bit;        // Position of the field in the packed word
+    bool resolved;     // Whether index and packed are valid for the current recipe
+    bool present;      // Whether the field is part of the current recipe
+    bool packed;       // Whether the field has to be read from the packed word
+    size_t index;      // Position of the field or its packed word in the current recipe
+  };
+
+  void resolve(Watch& watch, const DataPackage& package);
+
+  std::vector<Watch> watches_;
+  std::shared_ptr<const std::vector<std::string>> recipe_;
+  mutable std::mutex watches_mutex_;
+  std::atomic<std::chrono::microseconds> budget_;
+  std::atomic<uint64_t> overruns_;
+};
+
+}  // namespace rtde_interface
+}  // namespace urcl
+
+#endif  // UR_CLIENT_LIBRARY_RTDE_EDGE_MONITOR_H_INCLUDED
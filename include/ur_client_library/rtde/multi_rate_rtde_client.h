@@ -0,0 +1,226 @@
+// this is for emacs file handling -*- mode: c++; indent-tabs-mode: nil -*-
+
+// -- BEGIN LICENSE BLOCK ----------------------------------------------
+// Copyright 2026 Universal Robots A/S
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -- END LICENSE BLOCK ------------------------------------------------
+
+//----------------------------------------------------------------------
+/*!\file
+ *
+ * \date    2026-10-19
+ *
+ */
+//----------------------------------------------------------------------
+
+
+#ifndef UR_CLIENT_LIBRARY_MULTI_RATE_RTDE_CLIENT_H_INCLUDED
+#define UR_CLIENT_LIBRARY_MULTI_RATE_RTDE_CLIENT_H_INCLUDED
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "ur_client_library/rtde/rtde_client.h"
+
+namespace urcl
+{
+namespace rtde_interface
+{
+/*!
+ * \brief Configuration of one output stream of a MultiRateRTDEClient.
+ */
+struct RTDEStreamConfig
+{
+  std::vector<std::string> output_recipe;  //!< Variable names received on this stream
+  double frequency = 0.0;                  //!< Stream frequency, 0.0 means the robot's maximum frequency
+};
+
+/*!
+ * \brief Manages several RTDE connections running at different frequencies and merges their data
+ * into one consolidated state.
+ *
+ * Every stream gets its own RTDEClient and thus its own connection, recipe and frequency. A reader
+ * thread per stream decodes only the fields of that stream's recipe and writes them into a shared
+ * state together with the time the package carrying them was received. That way fast changing
+ * fields such as \p actual_q can run at the robot's full rate while slowly changing fields like
+ * \p joint_temperatures are only decoded as often as needed.
+ *
+ * The input recipe, if any, is set up on the first stream, so getWriter() returns that stream's
+ * writer.
+ */
+class MultiRateRTDEClient
+{
+public:
+  MultiRateRTDEClient() = delete;
+  /*!
+   * \brief Creates one RTDEClient per stream configuration.
+   *
+   * \param robot_ip The IP of the robot
+   * \param notifier The notifier to use in the clients' pipelines
+   * \param streams Output recipe and frequency of each stream
+   * \param input_recipe Variable names of the input recipe, set up on the first stream
+   *
+   * \throws UrException if no stream is given.
+   */
+  MultiRateRTDEClient(const std::string& robot_ip, comm::INotifier& notifier,
+                      const std::vector<RTDEStreamConfig>& streams,
+                      const std::vector<std::string>& input_recipe = {});
+  ~MultiRateRTDEClient();
+
+  /*!
+   * \brief Sets up all streams. The connections are initialized concurrently. Afterwards, the
+   * consolidated state holds an entry for every field of every stream, so merging received data
+   * doesn't need to allocate.
+   *
+   * \returns True if every stream was set up successfully, false otherwise
+   */
+  bool init();
+
+  /*!
+   * \brief Starts the data transfer on all streams and the reader threads merging their data.
+   *
+   * \returns True if every stream could be started, false otherwise. If a stream fails to start,
+   * the streams started before are paused again.
+   */
+  bool start();
+
+  /*!
+   * \brief Stops the reader threads and pauses the data transfer on all streams.
+   *
+   * \returns True if every stream could be paused, false otherwise
+   */
+  bool pause();
+
+  /*!
+   * \brief Get the latest value of a field from the consolidated state.
+   *
+   * \param name The name of the field as used in the output recipe
+   * \param val Target variable holding the field's value afterwards
+   *
+   * \throws std::bad_variant_access if the field's type does not match T.
+   *
+   * \returns True on success, false if the field has not been received yet.
+   */
+  template <typename T>
+  bool getData(const std::string& name, T& val) const
+  {
+    std::lock_guard<std::mutex> lk(state_mutex_);
+    auto it = state_.find(name);
+    if (it != state_.end())
+    {
+      if (!it->second.received)
+      {
+        return false;
+      }
+      val = std::get<T>(it->second.value);
+      return true;
+    }
+    if constexpr (std::is_same<T, bool>::value)
+    {
+      // Bit registers might have been packed into a word by the stream's client
+      std::string word;
+      size_t bit;
+      if (DataPackage::getPackedBitRegister(name, word, bit) && (it = state_.find(word)) != state_.end() &&
+          it->second.received)
+      {
+        val = (std::get<uint32_t>(it->second.value) >> bit) & 1;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /*!
+   * \brief Get the time the latest value of a field was received.
+   *
+   * \param name The name of the field as used in the output recipe
+   * \param updated Kernel receive time of the package carrying the latest value
+   *
+   * \returns True on success, false if the field has not been received yet.
+   */
+  bool getUpdateTime(const std::string& name, std::chrono::system_clock::time_point& updated) const;
+
+  /*!
+   * \brief Blocks until a stream delivered a new package.
+   *
+   * \param stream Index of the stream as given in the constructor
+   * \param timeout Maximum time to wait
+   *
+   * \returns True if new data arrived within the timeout, false otherwise
+   */
+  bool waitForUpdate(const size_t stream, const std::chrono::milliseconds timeout);
+
+  /*!
+   * \brief Number of managed streams.
+   */
+  size_t getNumStreams() const
+  {
+    return clients_.size();
+  }
+
+  /*!
+   * \brief Access the RTDEClient handling a stream, e.g. to configure it before init().
+   *
+   * \param stream Index of the stream as given in the constructor
+   */
+  RTDEClient& getClient(const size_t stream)
+  {
+    return *clients_.at(stream);
+  }
+
+  /*!
+   * \brief Getter for the RTDE writer of the first stream, which carries the input recipe.
+   */
+  RTDEWriter& getWriter()
+  {
+    return clients_.front()->getWriter();
+  }
+
+private:
+  struct Field
+  {
+    DataPackage::_rtde_type_variant value;
+    std::chrono::system_clock::time_point updated;
+    bool received = false;
+  };
+
+  void readStream(const size_t stream);
+  void stopReaders();
+
+  std::vector<std::unique_ptr<RTDEClient>> clients_;
+  std::vector<std::vector<std::string>> recipes_;
+  std::vector<std::thread> readers_;
+  std::atomic<bool> running_;
+
+  mutable std::mutex state_mutex_;
+  std::condition_variable update_cv_;
+  std::unordered_map<std::string, Field> state_;
+  // Entries of state_ for each field of each stream's recipe. Elements of an unordered_map keep their
+  // address, so the readers can write to them directly.
+  std::vector<std::vector<Field*>> fields_;
+  std::vector<uint64_t> update_counts_;
+};
+
+}  // namespace rtde_interface
+}  // namespace urcl
+
+#endif  // UR_CLIENT_LIBRARY_MULTI_RATE_RTDE_CLIENT_H_INCLUDED
@@ -0,0 +1,116 @@
+// this is for emacs file handling -*- mode: c++; indent-tabs-mode: nil -*-
+
+// -- BEGIN LICENSE BLOCK ----------------------------------------------
+// Copyright 2026 Universal Robots A/S
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -- END LICENSE BLOCK ------------------------------------------------
+
+//----------------------------------------------------------------------
+/*!\file
+ *
+ * \date    2026-10-19
+ *
+ */
+//----------------------------------------------------------------------
+
+
+
+#ifndef UR_CLIENT_LIBRARY_RTDE_NEGOTIATION_CACHE_H_INCLUDED
+#define UR_CLIENT_LIBRARY_RTDE_NEGOTIATION_CACHE_H_INCLUDED
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "ur_client_library/ur/version_information.h"
+
+namespace urcl
+{
+namespace rtde_interface
+{
+/*!
+ * \brief Identifies an RTDE session whose negotiation results can be reused.
+ */
+struct NegotiationKey
+{
+  std::string host;
+  int port;
+  std::vector<std::string> output_recipe;
+  std::vector<std::string> input_recipe;
+
+  bool operator<(const NegotiationKey& other) const;
+};
+
+/*!
+ * \brief Results of the RTDE handshake that don't have to be negotiated again.
+ */
+struct NegotiationResult
+{
+  uint16_t protocol_version;
+  VersionInformation urcontrol_version;
+};
+
+/*!
+ * \brief Thread-safe store of RTDE negotiation results.
+ *
+ * Results are only reused for a connection to the same host and port with the same recipes, so
+ * that a client with different recipes or a different robot behind the same address (e.g. a
+ * forwarded port) always performs a full handshake first.
+ */
+class NegotiationCache
+{
+public:
+  NegotiationCache() = default;
+  virtual ~NegotiationCache() = default;
+
+  /*!
+   * \brief Stores the negotiation results for a session, replacing previous results.
+   *
+   * \param key Session the results belong to
+   * \param result Negotiated protocol and urcontrol version
+   */
+  void store(const NegotiationKey& key, const NegotiationResult& result);
+
+  /*!
+   * \brief Looks up the negotiation results of a session.
+   *
+   * \param key Session to look up
+   * \param result Filled with the stored results, if there are any
+   *
+   * \returns True if results have been stored for the session
+   */
+  bool lookup(const NegotiationKey& key, NegotiationResult& result) const;
+
+  /*!
+   * \brief Forgets the negotiation results of a session, e.g. because the robot didn't accept them.
+   *
+   * \param key Session to forget
+   */
+  void erase(const NegotiationKey& key);
+
+  /*!
+   * \brief Forgets all stored negotiation results.
+   */
+  void clear();
+
+private:
+  mutable std::mutex mutex_;
+  std::map<NegotiationKey, NegotiationResult> results_;
+};
+
+}  // namespace rtde_interface
+}  // namespace urcl
+
+#endif  // UR_CLIENT_LIBRARY_RTDE_NEGOTIATION_CACHE_H_INCLUDED
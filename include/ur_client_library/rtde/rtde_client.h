@@ -41,6 +41,14 @@
 #include "ur_client_library/rtde/control_package_start.h"
 #include "ur_client_library/log.h"
 #include "ur_client_library/rtde/rtde_writer.h"
+#include "ur_client_library/rtde/control_channel.h"
+#include "ur_client_library/rtde/negotiation_cache.h"
+#include "ur_client_library/rtde/edge_monitor.h"
+#include "ur_client_library/rtde/clock_estimator.h"
+#include "ur_client_library/control/phase_locked_scheduler.h"
+
+#include <atomic>
+#include <thread>
 
 static const int UR_RTDE_PORT = 30004;
 static const std::string PIPELINE_NAME = "RTDE Data Pipeline";
@@ -50,8 +58,12 @@ namespace urcl
 namespace rtde_interface
 {
 static const uint16_t MAX_RTDE_PROTOCOL_VERSION = 2;
-static const unsigned MAX_REQUEST_RETRIES = 5;
 static const unsigned MAX_INITIALIZE_ATTEMPTS = 10;
+// Upper limit of the growing delay between two initialization attempts
+static const std::chrono::milliseconds MAX_INIT_RETRY_DELAY = std::chrono::seconds(10);
+// Replies are matched to their requests by the ControlChannel, so requests are not retried anymore. The constant is
+// only kept for API compatibility.
+[[deprecated("RTDE requests are not retried anymore")]] static const unsigned MAX_REQUEST_RETRIES = 5;
 
 enum class UrRtdeRobotStatusBits
 {
@@ -105,6 +117,20 @@ public:
    */
   RTDEClient(std::string robot_ip, comm::INotifier& notifier, const std::string& output_recipe_file,
              const std::string& input_recipe_file, double target_frequency = 0.0);
+
+  /*!
+   * \brief Creates a new RTDEClient object, including a used URStream and Pipeline to handle the
+   * communication with the robot.
+   *
+   * \param robot_ip The IP of the robot
+   * \param notifier The notifier to use in the pipeline
+   * \param output_recipe Variable names of the output recipe
+   * \param input_recipe Variable names of the input recipe. If empty, no inputs are set up and the
+   * writer can't be used.
+   * \param target_frequency Frequency to run at. Defaults to 0.0 which means maximum frequency.
+   */
+  RTDEClient(std::string robot_ip, comm::INotifier& notifier, const std::vector<std::string>& output_recipe,
+             const std::vector<std::string>& input_recipe, double target_frequency = 0.0);
   ~RTDEClient();
   /*!
    * \brief Sets up RTDE communication with the robot. The handshake includes negotiation of the
@@ -125,6 +151,22 @@ public:
    * \returns Wheter the RTDE data package communication was paussed succesfully
    */
   bool pause();
+  /*!
+   * \brief Changes the output recipe and the frequency of the RTDE data stream without
+   * reconnecting.
+   *
+   * If the client is running, it is paused, reconfigured and started again, so the data stream is
+   * only interrupted for a few round trips. If the robot doesn't accept the new configuration, the
+   * previous one is restored.
+   *
+   * \param output_recipe The new output recipe
+   * \param target_frequency The new frequency. 0 means the robot's maximum frequency. Changing the
+   * frequency requires RTDE protocol version 2.
+   *
+   * \returns True if the new configuration is in use, false otherwise
+   */
+  bool reconfigure(const std::vector<std::string>& output_recipe, const double target_frequency = 0.0);
+
   /*!
    * \brief Reads the pipeline to fetch the next data package.
    *
@@ -172,19 +214,227 @@ public:
   /*!
    * \brief Getter for the RTDE output recipe.
    *
-   * \returns The output recipe
+   * Individual output bit registers 0 to 63 are transferred as part of the packed words
+   * \p output_bit_registers0_to_31 and \p output_bit_registers32_to_63 when that saves space, in
+   * which case the returned recipe contains the packed words. The individual bits can still be
+   * read from the data packages by their own names.
+   *
+   * \returns The output recipe as sent to the robot
    */
   std::vector<std::string> getOutputRecipe()
   {
     return output_recipe_;
   }
 
+  /*!
+   * \brief Configures busy polling on the RTDE stream.
+   *
+   * In busy-poll mode the pipeline's producer thread spins on the socket instead of blocking in
+   * the kernel, which reduces the jitter introduced by scheduler wake-ups. This should be called
+   * before init().
+   *
+   * \param config Busy-poll configuration for the RTDE socket
+   * \param producer_cpu CPU core the polling thread should be pinned to. -1 disables pinning.
+   */
+  void setBusyPolling(const comm::BusyPollConfig& config, const int producer_cpu = -1);
+
+  /*!
+   * \brief Getter for the statistics gathered while busy polling the RTDE stream.
+   *
+   * \returns Spin iterations and number of packages received so far
+   */
+  comm::BusyPollStatistics getBusyPollStatistics() const
+  {
+    return stream_.getBusyPollStatistics();
+  }
+
+  /*!
+   * \brief Sets the time without data after which the RTDE link is considered lost while data is
+   * being streamed.
+   *
+   * If no data package arrives for longer than the given timeout after start() has been called,
+   * the connection is considered lost and the client tries to reconnect. Without a configured
+   * timeout, comm::URProducer::DEFAULT_LINK_LOSS_TIMEOUT is used. As RTDE sends data with up to
+   * 500 Hz, a timeout of a few cycles is usually sufficient.
+   *
+   * \param timeout Time without data after which the link is considered lost. 0 restores the
+   * default.
+   */
+  void setLinkLossTimeout(const std::chrono::milliseconds timeout)
+  {
+    prod_.setLinkLossTimeout(timeout);
+  }
+
+  /*!
+   * \brief Registers a callback that is triggered whenever the health of the RTDE connection
+   * changes. The callback is executed in the pipeline's producer thread and should return quickly.
+   *
+   * \param callback Function receiving the new connection health
+   */
+  void setConnectionHealthCallback(std::function<void(comm::ConnectionHealth)> callback)
+  {
+    prod_.setConnectionHealthCallback(callback);
+  }
+
+  /*!
+   * \brief Getter for the current health of the RTDE connection.
+   *
+   * \returns The connection health
+   */
+  comm::ConnectionHealth getConnectionHealth() const
+  {
+    return prod_.getConnectionHealth();
+  }
+
+  /*!
+   * \brief Enables or disables reusing negotiation results for faster startup.
+   *
+   * When enabled (the default), the protocol version and urcontrol version negotiated with a robot
+   * are remembered for the lifetime of the process. Subsequent initializations for the same robot
+   * address and recipes send all setup requests at once instead of waiting for each reply and skip
+   * checking whether the robot has finished booting, as that has been checked when the results
+   * were stored. If the robot doesn't accept the cached protocol version, a full handshake is
+   * performed.
+   *
+   * \param enabled Whether to use cached negotiation results
+   */
+  void setFastStart(const bool enabled)
+  {
+    fast_start_ = enabled;
+  }
+
+  /*!
+   * \brief Sets the time to wait after the first failed attempt of initializing the client.
+   *
+   * The delay doubles with every further failed attempt, up to MAX_INIT_RETRY_DELAY or the given
+   * delay, whichever is larger. It defaults to one second, so a short hiccup doesn't delay the
+   * startup much, while waiting for a booting robot is still covered by the growing delay.
+   *
+   * \param delay Time to wait after the first failed initialization attempt
+   */
+  void setInitRetryDelay(const std::chrono::milliseconds delay)
+  {
+    init_retry_delay_ = delay;
+  }
+
+  /*!
+   * \brief Configures how RTDE packages that cannot be parsed are handled. In resync mode, such
+   * packages are dropped instead of closing the connection. This should be called before init().
+   *
+   * \param config Resync configuration to use
+   */
+  void setResyncConfig(const comm::ResyncConfig& config)
+  {
+    prod_.setResyncConfig(config);
+  }
+
+  /*!
+   * \brief Getter for the connection state of the RTDE stream.
+   *
+   * \returns The connection state as reported by the RTDE producer
+   */
+  comm::ProducerState getConnectionState() const
+  {
+    return prod_.getState();
+  }
+
+  /*!
+   * \brief Registers a callback that is triggered whenever the connection state of the RTDE stream
+   * changes, e.g. when the connection is lost or re-established.
+   *
+   * After a reconnection the client restores the RTDE session (protocol version, recipes and, if the
+   * client was running, the data stream) in the background. The callback is executed in the
+   * pipeline's producer thread and should return quickly.
+   *
+   * \param callback Function receiving the new connection state
+   */
+  void setConnectionStateCallback(std::function<void(comm::ProducerState)> callback)
+  {
+    connection_state_callback_ = callback;
+  }
+
+  /*!
+   * \brief Configures TCP keepalive and the user timeout of the RTDE socket. This should be called
+   * before init().
+   *
+   * \param config Keepalive configuration for the RTDE socket
+   */
+  void setKeepaliveConfig(const comm::KeepaliveConfig& config)
+  {
+    stream_.setKeepaliveConfig(config);
+  }
+
+  /*!
+   * \brief Registers a callback that is run whenever the given output field changes.
+   *
+   * Edge callbacks are run directly on the pipeline's producer thread right after a data package
+   * has been parsed, before the package is queued for getDataPackage(). See EdgeMonitor for the
+   * restrictions this implies. Callbacks can be registered at any time, but not from within an edge
+   * callback.
+   *
+   * \param field Name of a scalar field of the output recipe, e.g. \p safety_status_bits
+   * \param callback Function receiving the previous and current value of the field
+   *
+   * \returns False if the field is not part of the output recipe or can't be watched, true otherwise
+   */
+  bool addEdgeCallback(const std::string& field, EdgeMonitor::Callback callback);
+
+  /*!
+   * \brief Sets the time an edge callback may take before it is counted as overrun.
+   *
+   * \param budget Time budget per callback invocation
+   */
+  void setEdgeCallbackBudget(const std::chrono::microseconds budget)
+  {
+    edge_monitor_.setBudget(budget);
+  }
+
+  /*!
+   * \brief Number of edge callback invocations that exceeded their time budget.
+   */
+  uint64_t getEdgeCallbackOverruns() const
+  {
+    return edge_monitor_.getOverruns();
+  }
+
+  /*!
+   * \brief Feeds the receive time of every data package into the given scheduler.
+   *
+   * The scheduler is reset whenever the connection to the robot is lost, so it doesn't predict
+   * package arrivals based on the phase of the previous connection.
+   *
+   * \param scheduler Scheduler to feed, nullptr to stop feeding it. It has to outlive the client or
+   * be unregistered before it is destroyed.
+   */
+  void setPhaseLockedScheduler(control::PhaseLockedScheduler* scheduler)
+  {
+    scheduler_ = scheduler;
+  }
+
+  /*!
+   * \brief Getter for the estimate of the robot controller's clock.
+   *
+   * The estimator is fed with the \p timestamp field and the receive time of every data package,
+   * right after the package has been parsed on the producer thread. It becomes valid once enough
+   * packages have been received, see ClockEstimator for details.
+   *
+   * \returns The clock estimator of this client
+   */
+  const ClockEstimator& getClockEstimator() const
+  {
+    return clock_estimator_;
+  }
+
 private:
   comm::URStream<RTDEPackage> stream_;
   std::vector<std::string> output_recipe_;
   std::vector<std::string> input_recipe_;
   RTDEParser parser_;
   comm::URProducer<RTDEPackage> prod_;
+  ControlChannel control_channel_;
+  EdgeMonitor edge_monitor_;
+  ClockEstimator clock_estimator_;
+  std::atomic<control::PhaseLockedScheduler*> scheduler_;
   comm::Pipeline<RTDEPackage> pipeline_;
   RTDEWriter writer_;
 
@@ -194,19 +444,57 @@ private:
   double target_frequency_;
 
   ClientState client_state_;
+  uint16_t protocol_version_;
+
+  std::function<void(comm::ProducerState)> connection_state_callback_;
+  std::thread restore_thread_;
+  std::atomic<bool> restore_requested_;
+  std::atomic<bool> restoring_;
+
+  bool fast_start_;
+  std::chrono::milliseconds init_retry_delay_;
 
   constexpr static const double CB3_MAX_FREQUENCY = 125.0;
   constexpr static const double URE_MAX_FREQUENCY = 500.0;
+  constexpr static const std::chrono::milliseconds REQUEST_TIMEOUT = std::chrono::milliseconds(1000);
 
-  std::vector<std::string> readRecipe(const std::string& recipe_file);
+  static std::vector<std::string> readRecipe(const std::string& recipe_file);
 
   void setupCommunication();
+
+  /*!
+   * \brief Sets up the communication based on the negotiation results of a previous connection to
+   * the same robot. All requests are sent at once without waiting for the individual replies.
+   *
+   * \returns True if the cached results could be used, false if a full handshake is necessary
+   */
+  bool setupFromCache();
+  NegotiationKey getNegotiationKey();
+  void checkTargetFrequency();
+  ControlChannel::Reply sendRequest(const uint8_t* buffer, const size_t size, const PackageType reply_type);
+  std::unique_ptr<RTDEPackage> awaitReply(ControlChannel::Reply& reply);
+  ControlChannel::Reply sendProtocolVersionRequest(const uint16_t protocol_version);
+  ControlChannel::Reply sendOutputSetup(const uint16_t protocol_version);
+  ControlChannel::Reply sendInputSetup();
+  bool handleOutputSetupReply(std::unique_ptr<RTDEPackage> package);
+  bool handleInputSetupReply(std::unique_ptr<RTDEPackage> package);
   bool negotiateProtocolVersion(const uint16_t protocol_version);
   void queryURControlVersion();
   void setupOutputs(const uint16_t protocol_version);
   void setupInputs();
   void disconnect();
 
+  bool routeProduct(std::unique_ptr<RTDEPackage>& package);
+  void producerStateCallback(const comm::ProducerState state);
+  void runSessionRestore();
+
+  /*!
+   * \brief Replays the RTDE setup on a new connection after the connection to the robot was lost.
+   *
+   * \returns True if the session could be restored, false otherwise
+   */
+  bool restoreSession();
+
   /*!
    * \brief Checks wheter the robot is booted, this is done by looking at the timestamp from the robot controller, this
    * will show the time in seconds since the controller was started. If the timestamp is below 40, we will read from
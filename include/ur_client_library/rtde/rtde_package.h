@@ -68,6 +68,16 @@ public:
    */
   virtual std::string toString() const;
 
+  /*!
+   * \brief Getter for the type of the package.
+   *
+   * \returns The package type
+   */
+  PackageType getType() const
+  {
+    return type_;
+  }
+
 protected:
   std::unique_ptr<uint8_t> buffer_;
   size_t buffer_length_;
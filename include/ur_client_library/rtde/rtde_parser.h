@@ -19,6 +19,7 @@
  */
 
 #pragma once
+#include <mutex>
 #include <vector>
 #include "ur_client_library/comm/parser.h"
 #include "ur_client_library/comm/bin_parser.h"
@@ -51,7 +52,8 @@ public:
    *
    * \param recipe The recipe used in RTDE data communication
    */
-  RTDEParser(const std::vector<std::string>& recipe) : recipe_(recipe), protocol_version_(1)
+  RTDEParser(const std::vector<std::string>& recipe)
+    : recipe_(std::make_shared<const std::vector<std::string>>(recipe)), protocol_version_(1)
   {
   }
   virtual ~RTDEParser() = default;
@@ -83,7 +85,11 @@ public:
     {
       case PackageType::RTDE_DATA_PACKAGE:
       {
-        std::unique_ptr<RTDEPackage> package(new DataPackage(recipe_));
+        std::unique_ptr<RTDEPackage> package;
+        {
+          std::lock_guard<std::mutex> lock(recipe_mutex_);
+          package.reset(new DataPackage(recipe_));
+        }
 
         if (!package->parseWith(bp))
         {
@@ -116,13 +122,27 @@ public:
     return true;
   }
 
+  /*!
+   * \brief Changes the recipe used to parse data packages. This can be done while packages are
+   * being parsed. All data packages parsed with the same recipe share it, see
+   * DataPackage::getRecipe().
+   *
+   * \param recipe The new recipe
+   */
+  void setRecipe(const std::vector<std::string>& recipe)
+  {
+    std::lock_guard<std::mutex> lock(recipe_mutex_);
+    recipe_ = std::make_shared<const std::vector<std::string>>(recipe);
+  }
+
   void setProtocolVersion(uint16_t protocol_version)
   {
     protocol_version_ = protocol_version;
   }
 
 private:
-  std::vector<std::string> recipe_;
+  std::shared_ptr<const std::vector<std::string>> recipe_;
+  std::mutex recipe_mutex_;
   RTDEPackage* packageFromType(PackageType type)
   {
     switch (type)
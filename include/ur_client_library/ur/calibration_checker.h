@@ -28,6 +28,10 @@
 #ifndef UR_CLIENT_LIBRARY_UR_CALIBRATION_CHECKER_H_INCLUDED
 #define UR_CLIENT_LIBRARY_UR_CALIBRATION_CHECKER_H_INCLUDED
 
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
 #include <ur_client_library/comm/pipeline.h>
 
 #include <ur_client_library/primary/robot_state/kinematics_info.h>
@@ -107,10 +111,28 @@ public:
     return matches_;
   }
 
+  /*!
+   * \brief Blocks until the calibration has been checked.
+   *
+   * \param timeout Maximum time to wait for the kinematics information
+   *
+   * \returns True if the calibration has been checked, false if the timeout passed before or the
+   * wait was canceled
+   */
+  bool waitForCheck(const std::chrono::milliseconds timeout);
+
+  /*!
+   * \brief Makes waitForCheck() return right away, e.g. because the check isn't needed anymore.
+   */
+  void cancel();
+
 private:
   std::string expected_hash_;
-  bool checked_;
-  bool matches_;
+  std::atomic<bool> checked_;
+  std::atomic<bool> matches_;
+  std::atomic<bool> cancelled_;
+  std::mutex check_mutex_;
+  std::condition_variable check_cv_;
 };
 }  // namespace urcl
 
@@ -78,12 +78,6 @@ public:
    */
   std::string sendAndReceive(const std::string& command);
 
-protected:
-  virtual bool open(int socket_fd, struct sockaddr* address, size_t address_len)
-  {
-    return ::connect(socket_fd, address, address_len) == 0;
-  }
-
 private:
   bool send(const std::string& text);
   std::string read();
@@ -28,12 +28,15 @@
 #ifndef UR_CLIENT_LIBRARY_UR_UR_DRIVER_H_INCLUDED
 #define UR_CLIENT_LIBRARY_UR_UR_DRIVER_H_INCLUDED
 
+#include <chrono>
 #include <functional>
+#include <future>
 
 #include "ur_client_library/rtde/rtde_client.h"
 #include "ur_client_library/control/reverse_interface.h"
 #include "ur_client_library/control/trajectory_point_interface.h"
 #include "ur_client_library/control/script_sender.h"
+#include "ur_client_library/control/setpoint_sender.h"
 #include "ur_client_library/ur/tool_communication.h"
 #include "ur_client_library/ur/version_information.h"
 #include "ur_client_library/primary/robot_message/version_message.h"
@@ -41,6 +44,47 @@
 
 namespace urcl
 {
+class CalibrationChecker;
+
+/*!
+ * \brief Durations of the individual phases of a UrDriver's startup. Phases running concurrently
+ * overlap, so their sum is usually larger than the total startup time.
+ */
+struct StartupTimings
+{
+  std::chrono::microseconds rtde_init{ 0 };          ///< RTDE connection and handshake
+  std::chrono::microseconds secondary_connect{ 0 };  ///< Connecting to the secondary interface
+  std::chrono::microseconds servers{ 0 };            ///< Opening the reverse and trajectory servers
+  std::chrono::microseconds script_reading{ 0 };     ///< Reading the script file
+  std::chrono::microseconds script_rendering{ 0 };   ///< Filling in the script template
+  std::chrono::microseconds calibration_check{ 0 };  ///< Fetching and checking the calibration, if requested
+  std::chrono::microseconds total{ 0 };              ///< Time until the driver was fully constructed
+};
+
+/*!
+ * \brief Runs a function and measures how long it took. The duration is also stored if the function
+ * throws.
+ *
+ * \param duration Set to the time spent in \p func
+ * \param func Function to run
+ *
+ * \returns The return value of \p func
+ */
+template <typename F>
+auto measureDuration(std::chrono::microseconds& duration, F&& func) -> decltype(func())
+{
+  struct Stopwatch
+  {
+    std::chrono::microseconds& duration;
+    std::chrono::steady_clock::time_point start;
+    ~Stopwatch()
+    {
+      duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    }
+  } stopwatch{ duration, std::chrono::steady_clock::now() };
+  return func();
+}
+
 /*!
  * \brief This is the main class for interfacing the driver.
  *
@@ -164,6 +208,36 @@ public:
 
   virtual ~UrDriver() = default;
 
+  /*!
+   * \brief Constructs a new UrDriver object asynchronously.
+   *
+   * All independent parts of the startup (RTDE handshake, connection to the secondary interface,
+   * opening the local servers, reading the script file and, if a checksum is given, fetching the
+   * robot's calibration) run concurrently. The parameters are the same as for the constructors.
+   * If \p calibration_checksum is not empty, the calibration is checked as part of the startup and
+   * the result is logged.
+   *
+   * \returns A future holding the constructed driver. If the construction fails, the future
+   * holds the exception thrown.
+   */
+  static std::future<std::unique_ptr<UrDriver>>
+  create(const std::string& robot_ip, const std::string& script_file, const std::string& output_recipe_file,
+         const std::string& input_recipe_file, std::function<void(bool)> handle_program_state, bool headless_mode,
+         std::unique_ptr<ToolCommSetup> tool_comm_setup = nullptr, const std::string& calibration_checksum = "",
+         const uint32_t reverse_port = 50001, const uint32_t script_sender_port = 50002, int servoj_gain = 2000,
+         double servoj_lookahead_time = 0.03, bool non_blocking_read = false, const std::string& reverse_ip = "",
+         const uint32_t trajectory_port = 50003);
+
+  /*!
+   * \brief Getter for the time spent in the individual phases of the driver's startup.
+   *
+   * \returns The startup timings
+   */
+  StartupTimings getStartupTimings() const
+  {
+    return startup_timings_;
+  }
+
   /*!
    * \brief Access function to receive the latest data package sent from the robot through RTDE
    * interface.
@@ -189,6 +263,49 @@ public:
    */
   bool writeJointCommand(const vector6d_t& values, const comm::ControlMode control_mode);
 
+  /*!
+   * \brief Starts a dedicated real-time thread that sends the newest published joint command once
+   * per control cycle. Use publishJointCommand() instead of writeJointCommand() while it runs.
+   *
+   * \param config Real-time settings applied to the sender thread
+   * \param keepalive_cycles Cycles without a new command after which a keepalive is sent, 0 to derive
+   * them from the robot's read timeout. See control::SetpointSender for details.
+   */
+  void startSetpointSender(const control::RealtimeConfig& config = control::RealtimeConfig(),
+                           const uint32_t keepalive_cycles = 0);
+
+  /*!
+   * \brief Stops the setpoint sender thread started by startSetpointSender().
+   */
+  void stopSetpointSender();
+
+  /*!
+   * \brief Publishes a joint command to the setpoint sender thread without blocking. Has no effect
+   * unless startSetpointSender() was called.
+   *
+   * \param values Desired joint positions
+   * \param control_mode Control mode this command is assigned to.
+   *
+   * \returns True if a setpoint sender is running.
+   */
+  bool publishJointCommand(const vector6d_t& values, const comm::ControlMode control_mode);
+
+  /*!
+   * \brief Writes a force mode command onto the socket being sent to the robot. See
+   * control::ReverseInterface::writeForceCommand() for details on the parameters.
+   *
+   * \param wrench Forces and torques the robot applies in compliant axes
+   * \param selection 1 for compliant axes, 0 for non-compliant axes
+   * \param limits Maximum TCP speeds for compliant axes, maximum deviations for non-compliant axes
+   * \param task_frame Pose of the task frame relative to the base frame
+   * \param type Type of the force frame
+   *
+   * \returns True on successful write.
+   */
+  bool writeForceCommand(const vector6d_t& wrench, const vector6uint32_t& selection, const vector6d_t& limits,
+                         const vector6d_t& task_frame,
+                         const control::ForceModeType type = control::ForceModeType::FRAME);
+
   /*!
    * \brief Writes a trajectory point onto the dedicated socket.
    *
@@ -202,6 +319,54 @@ public:
   bool writeTrajectoryPoint(const vector6d_t& values, const bool cartesian, const float goal_time = 0.0,
                             const float blend_radius = 0.052);
 
+  /*!
+   * \brief Writes a batch of trajectory points onto the dedicated socket with as few socket writes
+   * as possible.
+   *
+   * \param positions Array of desired joint or cartesian positions, one per point
+   * \param goal_times Array of times for the robot to reach each point
+   * \param blend_radii Array of blend radii, one per point. May be nullptr to use no blending.
+   * \param num_points Number of points in the arrays
+   * \param cartesian True, if the points sent are cartesian, false if joint-based
+   *
+   * \returns True on successful write.
+   */
+  bool writeTrajectoryPoints(const vector6d_t* positions, const float* goal_times, const float* blend_radii,
+                             const size_t num_points, const bool cartesian);
+
+  /*!
+   * \brief Writes a batch of trajectory points given as an array of points onto the dedicated
+   * socket with as few socket writes as possible.
+   *
+   * \param points Array of trajectory points
+   * \param num_points Number of points in the array
+   * \param cartesian True, if the points sent are cartesian, false if joint-based
+   *
+   * \returns True on successful write.
+   */
+  bool writeTrajectoryPoints(const control::TrajectoryPoint* points, const size_t num_points, const bool cartesian);
+
+  /*!
+   * \brief Starts a trajectory and streams its points to the robot, keeping at most \p window
+   * points in flight.
+   *
+   * The robot reports consumed points, so points are only sent as the robot makes progress. This
+   * blocks until all points have been sent, the trajectory ended or the robot disconnected. The
+   * execution result is reported through the callback registered with
+   * registerTrajectoryDoneCallback().
+   *
+   * \param positions Array of desired joint or cartesian positions, one per point
+   * \param goal_times Array of times for the robot to reach each point
+   * \param blend_radii Array of blend radii, one per point. May be nullptr to use no blending.
+   * \param num_points Number of points in the arrays
+   * \param cartesian True, if the points sent are cartesian, false if joint-based
+   * \param window Maximum number of points sent but not yet consumed by the robot
+   *
+   * \returns True if all points were sent.
+   */
+  bool streamTrajectory(const vector6d_t* positions, const float* goal_times, const float* blend_radii,
+                        const size_t num_points, const bool cartesian, const size_t window = 16);
+
   /*!
    * \brief Writes a control message in trajectory forward mode.
    *
@@ -243,11 +408,15 @@ public:
    * \brief Checks if the kinematics information in the used model fits the actual robot.
    *
    * \param checksum Hash of the used kinematics information
+   * \param timeout Maximum time to wait for the robot to send its kinematics information
+   *
+   * \throws TimeoutException if the robot didn't send its kinematics information in time
    *
    * \returns True if the robot's calibration checksum matches the one given to the checker. False
-   * if it doesn't match or the check was not yet performed.
+   * if it doesn't match.
    */
-  bool checkCalibration(const std::string& checksum);
+  bool checkCalibration(const std::string& checksum,
+                        const std::chrono::milliseconds timeout = std::chrono::milliseconds(10000));
 
   /*!
    * \brief Getter for the RTDE writer used to write to the robot's RTDE interface.
@@ -298,6 +467,16 @@ public:
    */
   void setKeepaliveCount(const uint32_t& count);
 
+  /*!
+   * \brief Configures TCP keepalive and the user timeout on all connections to the robot.
+   *
+   * Connections that are already established are updated immediately, the robot's connections to
+   * the reverse and trajectory interfaces use the configuration once they are (re-)established.
+   *
+   * \param config Keepalive configuration to use
+   */
+  void setKeepaliveConfig(const comm::KeepaliveConfig& config);
+
   /*!
    * \brief Register a callback for the robot-based trajectory execution completion.
    *
@@ -313,12 +492,26 @@ public:
   }
 
 private:
+  struct InitTag
+  {
+  };
+
+  UrDriver(InitTag, const std::string& calibration_checksum, const std::string& robot_ip,
+           const std::string& script_file, const std::string& output_recipe_file, const std::string& input_recipe_file,
+           std::function<void(bool)> handle_program_state, bool headless_mode,
+           std::unique_ptr<ToolCommSetup> tool_comm_setup, const uint32_t reverse_port,
+           const uint32_t script_sender_port, int servoj_gain, double servoj_lookahead_time, bool non_blocking_read,
+           const std::string& reverse_ip, const uint32_t trajectory_port);
+
   std::string readScriptFile(const std::string& filename);
+  bool runCalibrationCheck(CalibrationChecker& checker, const std::chrono::milliseconds timeout);
+  void logCalibrationResult(const bool calibration_matches) const;
 
   int rtde_frequency_;
   comm::INotifier notifier_;
   std::unique_ptr<rtde_interface::RTDEClient> rtde_client_;
   std::unique_ptr<control::ReverseInterface> reverse_interface_;
+  std::unique_ptr<control::SetpointSender> setpoint_sender_;
   std::unique_ptr<control::TrajectoryPointInterface> trajectory_interface_;
   std::unique_ptr<control::ScriptSender> script_sender_;
   std::unique_ptr<comm::URStream<primary_interface::PrimaryPackage>> primary_stream_;
@@ -338,6 +531,8 @@ private:
   bool non_blocking_read_;
 
   VersionInformation robot_version_;
+
+  StartupTimings startup_timings_;
 };
 }  // namespace urcl
 #endif  // ifndef UR_CLIENT_LIBRARY_UR_UR_DRIVER_H_INCLUDED
@@ -0,0 +1,104 @@
+// this is for emacs file handling -*- mode: c++; indent-tabs-mode: nil -*-
+
+// -- BEGIN LICENSE BLOCK ----------------------------------------------
+// Copyright 2026 Universal Robots A/S
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -- END LICENSE BLOCK ------------------------------------------------
+
+//----------------------------------------------------------------------
+/*!\file
+ *
+ * \date    2026-10-19
+ *
+ */
+//----------------------------------------------------------------------
+
+#include "ur_client_library/comm/connection_health.h"
+
+namespace urcl
+{
+namespace comm
+{
+ConnectionHealthMonitor::ConnectionHealthMonitor()
+  : health_(ConnectionHealth::UNKNOWN)
+  , last_receive_(0)
+  , suspended_(false)
+  , stale_timeout_(std::chrono::milliseconds(0))
+  , lost_timeout_(std::chrono::milliseconds(0))
+{
+}
+
+void ConnectionHealthMonitor::setTimeouts(const std::chrono::milliseconds stale_timeout,
+                                          const std::chrono::milliseconds lost_timeout)
+{
+  stale_timeout_ = stale_timeout;
+  lost_timeout_ = lost_timeout;
+}
+
+void ConnectionHealthMonitor::reset()
+{
+  transition(ConnectionHealth::UNKNOWN);
+}
+
+void ConnectionHealthMonitor::suspend()
+{
+  suspended_ = true;
+  transition(ConnectionHealth::UNKNOWN);
+}
+
+void ConnectionHealthMonitor::resume()
+{
+  suspended_ = false;
+  transition(ConnectionHealth::UNKNOWN);
+}
+
+void ConnectionHealthMonitor::notifyReceived(const Clock::time_point& time)
+{
+  last_receive_ = time.time_since_epoch().count();
+  if (!suspended_)
+  {
+    transition(ConnectionHealth::HEALTHY);
+  }
+}
+
+ConnectionHealth ConnectionHealthMonitor::check(const Clock::time_point& now)
+{
+  if (!isEnabled() || suspended_ || health_ == ConnectionHealth::UNKNOWN)
+  {
+    return health_;
+  }
+
+  const std::chrono::milliseconds stale_timeout = stale_timeout_;
+  auto silence = now - Clock::time_point(Clock::duration(last_receive_.load()));
+  if (silence > lost_timeout_.load())
+  {
+    transition(ConnectionHealth::LOST);
+  }
+  else if (stale_timeout.count() > 0 && silence > stale_timeout)
+  {
+    transition(ConnectionHealth::STALE);
+  }
+  return health_;
+}
+
+void ConnectionHealthMonitor::transition(const ConnectionHealth health)
+{
+  if (health_.exchange(health) != health && callback_)
+  {
+    callback_(health);
+  }
+}
+
+}  // namespace comm
+}  // namespace urcl
@@ -0,0 +1,72 @@
+// this is for emacs file handling -*- mode: c++; indent-tabs-mode: nil -*-
+
+// -- BEGIN LICENSE BLOCK ----------------------------------------------
+// Copyright 2026 Universal Robots A/S
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -- END LICENSE BLOCK ------------------------------------------------
+
+//----------------------------------------------------------------------
+/*!\file
+ *
+ * \date    2026-10-19
+ *
+ */
+//----------------------------------------------------------------------
+
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <cerrno>
+#include <cstring>
+
+#include "ur_client_library/log.h"
+#include "ur_client_library/comm/socket_options.h"
+
+namespace urcl
+{
+namespace comm
+{
+bool applyKeepaliveConfig(const int socket_fd, const KeepaliveConfig& config)
+{
+  if (!config.enabled)
+  {
+    return true;
+  }
+
+  bool success = true;
+  int flag = 1;
+  success &= setsockopt(socket_fd, SOL_SOCKET, SO_KEEPALIVE, &flag, sizeof(int)) == 0;
+
+  int idle = static_cast<int>(config.idle.count());
+  int interval = static_cast<int>(config.interval.count());
+  int count = config.count;
+  success &= setsockopt(socket_fd, IPPROTO_TCP, TCP_KEEPIDLE, &idle, sizeof(int)) == 0;
+  success &= setsockopt(socket_fd, IPPROTO_TCP, TCP_KEEPINTVL, &interval, sizeof(int)) == 0;
+  success &= setsockopt(socket_fd, IPPROTO_TCP, TCP_KEEPCNT, &count, sizeof(int)) == 0;
+
+  if (config.user_timeout.count() > 0)
+  {
+    unsigned int user_timeout = static_cast<unsigned int>(config.user_timeout.count());
+    success &= setsockopt(socket_fd, IPPROTO_TCP, TCP_USER_TIMEOUT, &user_timeout, sizeof(user_timeout)) == 0;
+  }
+
+  if (!success)
+  {
+    URCL_LOG_WARN("Could not apply keepalive configuration to socket %d: %s", socket_fd, strerror(errno));
+  }
+  return success;
+}
+
+}  // namespace comm
+}  // namespace urcl
@@ -33,8 +33,10 @@
 
 #include <sstream>
 #include <strings.h>
+#include <cerrno>
 #include <cstring>
 #include <fcntl.h>
+#include <poll.h>
 #include <algorithm>
 #include <system_error>
 
@@ -139,6 +141,15 @@ void TCPServer::bind()
     ss << "Failed to bind socket for port " << port_ << " to address. Reason: " << strerror(errno);
     throw std::system_error(std::error_code(errno, std::generic_category()), ss.str());
   }
+  if (port_ == 0)
+  {
+    // Let the operating system choose a free port and remember which one it is.
+    socklen_t len = sizeof(server_addr);
+    if (getsockname(listen_fd_, (struct sockaddr*)&server_addr, &len) == 0)
+    {
+      port_ = ntohs(server_addr.sin_port);
+    }
+  }
   URCL_LOG_DEBUG("Bound %d:%d to FD %d", server_addr.sin_addr.s_addr, port_, (int)listen_fd_);
 
   FD_SET(listen_fd_, &masterfds_);
@@ -171,6 +182,7 @@ void TCPServer::handleConnect()
 
   if (client_fds_.size() < max_clients_allowed_ || max_clients_allowed_ == 0)
   {
+    applyKeepaliveConfig(client_fd, keepalive_);
     client_fds_.push_back(client_fd);
     FD_SET(client_fd, &masterfds_);
     if (client_fd > maxfd_)
@@ -336,5 +348,56 @@ bool TCPServer::write(const int fd, const uint8_t* buf, const size_t buf_len, si
   return true;
 }
 
+bool TCPServer::writeNonBlocking(const int fd, const uint8_t* buf, const size_t buf_len, size_t& written)
+{
+  written = 0;
+  ssize_t sent = ::send(fd, buf, buf_len, MSG_DONTWAIT);
+  if (sent < 0)
+  {
+    if (errno == EAGAIN || errno == EWOULDBLOCK)
+    {
+      return true;
+    }
+    URCL_LOG_ERROR("Sending data through socket failed.");
+    return false;
+  }
+  written = static_cast<size_t>(sent);
+  return true;
+}
+
+bool TCPServer::writeNonBlocking(const int fd, const uint8_t* buf, const size_t buf_len, size_t& written,
+                                 const std::chrono::milliseconds timeout)
+{
+  written = 0;
+  const auto deadline = std::chrono::steady_clock::now() + timeout;
+  while (written < buf_len)
+  {
+    size_t sent;
+    if (!writeNonBlocking(fd, buf + written, buf_len - written, sent))
+    {
+      return false;
+    }
+    written += sent;
+    if (written == buf_len)
+    {
+      break;
+    }
+
+    const auto remaining =
+        std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+    if (remaining.count() <= 0)
+    {
+      break;
+    }
+    pollfd writable{ fd, POLLOUT, 0 };
+    if (::poll(&writable, 1, static_cast<int>(remaining.count())) < 0 && errno != EINTR)
+    {
+      URCL_LOG_ERROR("Waiting for socket to become writable failed.");
+      return false;
+    }
+  }
+  return true;
+}
+
 }  // namespace comm
 }  // namespace urcl
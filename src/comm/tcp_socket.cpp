@@ -22,11 +22,15 @@
 
 #include <arpa/inet.h>
 #include <endian.h>
+#include <fcntl.h>
 #include <netinet/tcp.h>
+#include <poll.h>
 #include <unistd.h>
+#include <algorithm>
 #include <cstring>
 #include <sstream>
 #include <thread>
+#include <vector>
 
 #include "ur_client_library/log.h"
 #include "ur_client_library/comm/tcp_socket.h"
@@ -35,7 +39,14 @@ namespace urcl
 {
 namespace comm
 {
-TCPSocket::TCPSocket() : socket_fd_(-1), state_(SocketState::Invalid)
+TCPSocket::TCPSocket()
+  : socket_fd_(-1)
+  , state_(SocketState::Invalid)
+  , spin_iterations_(0)
+  , spin_reads_(0)
+  , blocking_reads_(0)
+  , setup_cancelled_(false)
+  , packages_read_(0)
 {
 }
 TCPSocket::~TCPSocket()
@@ -55,13 +66,49 @@ void TCPSocket::setOptions(int socket_fd)
   }
 }
 
-bool TCPSocket::setup(std::string& host, int port)
+void TCPSocket::applyBusyPollOptions(int socket_fd)
+{
+  if (!busy_poll_.enabled || busy_poll_.kernel_busy_poll_us <= 0)
+  {
+    return;
+  }
+
+  // Raising SO_BUSY_POLL above net.core.busy_read requires CAP_NET_ADMIN. Without it, we still spin
+  // in user space, so this is not treated as an error.
+#ifdef SO_BUSY_POLL
+  int busy_poll_us = busy_poll_.kernel_busy_poll_us;
+  if (setsockopt(socket_fd, SOL_SOCKET, SO_BUSY_POLL, &busy_poll_us, sizeof(int)) != 0)
+  {
+    URCL_LOG_WARN("Could not set SO_BUSY_POLL on socket: %s", strerror(errno));
+  }
+#endif
+#ifdef SO_PREFER_BUSY_POLL
+  int flag = 1;
+  if (setsockopt(socket_fd, SOL_SOCKET, SO_PREFER_BUSY_POLL, &flag, sizeof(int)) != 0)
+  {
+    URCL_LOG_DEBUG("Could not set SO_PREFER_BUSY_POLL on socket: %s", strerror(errno));
+  }
+#endif
+}
+
+bool TCPSocket::setup(const std::string& host, const int port, const bool single_try)
 {
   if (state_ == SocketState::Connected)
     return false;
 
   URCL_LOG_DEBUG("Setting up connection: %s:%d", host.c_str(), port);
 
+  // A cancellation only applies to one setup. It is reset when the setup is done instead of when it
+  // starts, so a cancellation issued right before the setup isn't lost.
+  struct CancellationReset
+  {
+    std::atomic<bool>& cancelled;
+    ~CancellationReset()
+    {
+      cancelled = false;
+    }
+  } cancellation_reset{ setup_cancelled_ };
+
   // gethostbyname() is deprecated so use getadderinfo() as described in:
   // https://beej.us/guide/bgnet/html/#getaddrinfoprepare-to-launch
 
@@ -74,42 +121,187 @@ bool TCPSocket::setup(std::string& host, int port)
   hints.ai_socktype = SOCK_STREAM;
   hints.ai_flags = AI_PASSIVE;
 
-  bool connected = false;
-  while (!connected)
+  ConnectionConfig config = getConnectionConfig();
+  if (single_try)
+  {
+    config.max_num_tries = 1;
+  }
+  std::chrono::milliseconds backoff = config.initial_backoff;
+  for (size_t attempt = 1;; ++attempt)
   {
     if (getaddrinfo(host_name, service.c_str(), &hints, &result) != 0)
     {
       URCL_LOG_ERROR("Failed to get address for %s:%d", host.c_str(), port);
       return false;
     }
-    // loop through the list of addresses untill we find one that's connectable
-    for (struct addrinfo* p = result; p != nullptr; p = p->ai_next)
-    {
-      socket_fd_ = ::socket(p->ai_family, p->ai_socktype, p->ai_protocol);
+    int socket_fd = raceConnect(result);
+    freeaddrinfo(result);
 
-      if (socket_fd_ != -1 && open(socket_fd_, p->ai_addr, p->ai_addrlen))
-      {
-        connected = true;
-        break;
-      }
+    if (socket_fd >= 0)
+    {
+      socket_fd_ = socket_fd;
+      break;
     }
 
-    freeaddrinfo(result);
+    state_ = SocketState::Invalid;
+    if (setup_cancelled_)
+    {
+      URCL_LOG_DEBUG("Connection setup for %s:%d canceled", host.c_str(), port);
+      return false;
+    }
+    if (config.max_num_tries > 0 && attempt >= config.max_num_tries)
+    {
+      URCL_LOG_ERROR("Failed to connect to robot on IP %s after %zu attempts. Please check that the robot is booted "
+                     "and reachable on %s.",
+                     host.c_str(), attempt, host.c_str());
+      return false;
+    }
 
-    if (!connected)
+    std::stringstream ss;
+    ss << "Failed to connect to robot on IP " << host << ". Please check that the robot is booted and reachable on "
+       << host << ". Retrying in " << backoff.count() << " ms";
+    URCL_LOG_ERROR("%s", ss.str().c_str());
+    if (!waitForRetry(backoff))
     {
-      state_ = SocketState::Invalid;
-      std::stringstream ss;
-      ss << "Failed to connect to robot on IP " << host_name
-         << ". Please check that the robot is booted and reachable on " << host_name << ". Retrying in 10 seconds";
-      URCL_LOG_ERROR("%s", ss.str().c_str());
-      std::this_thread::sleep_for(std::chrono::seconds(10));
+      URCL_LOG_DEBUG("Connection setup for %s:%d canceled", host.c_str(), port);
+      return false;
     }
+    backoff = std::min(config.max_backoff, std::chrono::duration_cast<std::chrono::milliseconds>(
+                                               backoff * config.backoff_factor));
   }
   setOptions(socket_fd_);
+  applyKeepaliveConfig(socket_fd_, keepalive_);
+  applyBusyPollOptions(socket_fd_);
+  // Unlike TCP_QUICKACK, receive timestamps stay enabled, so this doesn't belong into setOptions(),
+  // which is called for every read.
+  int flag = 1;
+  setsockopt(socket_fd_, SOL_SOCKET, SO_TIMESTAMPNS, &flag, sizeof(int));
   state_ = SocketState::Connected;
   URCL_LOG_DEBUG("Connection established for %s:%d", host.c_str(), port);
-  return connected;
+  return true;
+}
+
+int TCPSocket::raceConnect(struct addrinfo* addresses)
+{
+  using Clock = std::chrono::steady_clock;
+  const ConnectionConfig config = getConnectionConfig();
+
+  std::vector<struct pollfd> pending;
+  std::vector<Clock::time_point> deadlines;
+  struct addrinfo* next = addresses;
+  Clock::time_point next_start = Clock::now();
+
+  auto close_pending = [&pending]() {
+    for (auto& pfd : pending)
+    {
+      ::close(pfd.fd);
+    }
+  };
+
+  while (!setup_cancelled_)
+  {
+    Clock::time_point now = Clock::now();
+
+    // Start connecting to the next address either after the stagger delay or as soon as all
+    // previously started attempts failed.
+    if (next != nullptr && (now >= next_start || pending.empty()))
+    {
+      struct addrinfo* p = next;
+      next = next->ai_next;
+      next_start = now + config.address_stagger;
+
+      int fd = ::socket(p->ai_family, p->ai_socktype | SOCK_NONBLOCK, p->ai_protocol);
+      if (fd == -1)
+      {
+        continue;
+      }
+      if (::connect(fd, p->ai_addr, p->ai_addrlen) == 0)
+      {
+        close_pending();
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) & ~O_NONBLOCK);
+        return fd;
+      }
+      if (errno != EINPROGRESS)
+      {
+        ::close(fd);
+        continue;
+      }
+      pending.push_back({ fd, POLLOUT, 0 });
+      deadlines.push_back(now + config.connect_timeout);
+      continue;
+    }
+
+    if (pending.empty())
+    {
+      return -1;
+    }
+
+    // Wake up regularly to check for cancellation, stagger and connect timeouts.
+    Clock::time_point wake_up = now + std::chrono::milliseconds(10);
+    if (next != nullptr)
+    {
+      wake_up = std::min(wake_up, next_start);
+    }
+    for (auto& deadline : deadlines)
+    {
+      wake_up = std::min(wake_up, deadline);
+    }
+    int timeout_ms =
+        static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(wake_up - now).count());
+    if (::poll(pending.data(), pending.size(), std::max(timeout_ms, 0)) < 0 && errno != EINTR)
+    {
+      close_pending();
+      return -1;
+    }
+
+    now = Clock::now();
+    for (size_t i = 0; i < pending.size();)
+    {
+      if (pending[i].revents != 0)
+      {
+        int error = 0;
+        socklen_t len = sizeof(error);
+        if (getsockopt(pending[i].fd, SOL_SOCKET, SO_ERROR, &error, &len) == 0 && error == 0)
+        {
+          // First address to connect wins the race. Go back to blocking operation for it.
+          int fd = pending[i].fd;
+          pending.erase(pending.begin() + i);
+          close_pending();
+          fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) & ~O_NONBLOCK);
+          return fd;
+        }
+      }
+      else if (now < deadlines[i])
+      {
+        ++i;
+        continue;
+      }
+      ::close(pending[i].fd);
+      pending.erase(pending.begin() + i);
+      deadlines.erase(deadlines.begin() + i);
+    }
+  }
+
+  close_pending();
+  return -1;
+}
+
+bool TCPSocket::waitForRetry(const std::chrono::milliseconds& delay)
+{
+  std::unique_lock<std::mutex> lock(setup_mutex_);
+  return !setup_cv_.wait_for(lock, delay, [this] { return setup_cancelled_.load(); });
+}
+
+void TCPSocket::cancelSetup()
+{
+  std::lock_guard<std::mutex> lock(setup_mutex_);
+  setup_cancelled_ = true;
+  setup_cv_.notify_all();
+}
+
+void TCPSocket::resetSetupCancellation()
+{
+  setup_cancelled_ = false;
 }
 
 void TCPSocket::close()
@@ -149,24 +341,95 @@ bool TCPSocket::read(char* character)
 }
 
 bool TCPSocket::read(uint8_t* buf, const size_t buf_len, size_t& read)
+{
+  return tryRead(buf, buf_len, read) == ReadStatus::SUCCESS;
+}
+
+ReadStatus TCPSocket::tryRead(uint8_t* buf, const size_t buf_len, size_t& read)
 {
   read = 0;
 
   if (state_ != SocketState::Connected)
-    return false;
+    return ReadStatus::CLOSED;
 
-  ssize_t res = ::recv(socket_fd_, buf, buf_len, 0);
+  ssize_t res = busy_poll_.enabled ? spinReceive(buf, buf_len) : receive(buf, buf_len, 0);
 
   if (res == 0)
   {
     state_ = SocketState::Disconnected;
-    return false;
+    return ReadStatus::CLOSED;
   }
   else if (res < 0)
-    return false;
+  {
+    return (errno == EAGAIN || errno == EWOULDBLOCK) ? ReadStatus::TIMEOUT : ReadStatus::FAILED;
+  }
 
   read = static_cast<size_t>(res);
-  return true;
+  return ReadStatus::SUCCESS;
+}
+
+ssize_t TCPSocket::spinReceive(uint8_t* buf, const size_t buf_len)
+{
+  for (uint32_t i = 0; i < busy_poll_.spin_budget; ++i)
+  {
+    ssize_t res = receive(buf, buf_len, MSG_DONTWAIT);
+    if (res >= 0)
+    {
+      // Don't leave the EAGAIN of previous iterations behind for callers inspecting errno.
+      errno = 0;
+      spin_reads_.fetch_add(1, std::memory_order_relaxed);
+      return res;
+    }
+    if (errno != EAGAIN && errno != EWOULDBLOCK)
+    {
+      return res;
+    }
+    spin_iterations_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // Nothing arrived within the spin budget, so don't burn the core any longer.
+  blocking_reads_.fetch_add(1, std::memory_order_relaxed);
+  return receive(buf, buf_len, 0);
+}
+
+ssize_t TCPSocket::receive(uint8_t* buf, const size_t buf_len, const int flags)
+{
+  struct iovec iov;
+  iov.iov_base = buf;
+  iov.iov_len = buf_len;
+
+  // Ancillary data buffer large enough to hold the receive timestamp
+  alignas(struct cmsghdr) char control[CMSG_SPACE(sizeof(struct timespec))];
+
+  struct msghdr msg;
+  std::memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+
+  ssize_t res = ::recvmsg(socket_fd_, &msg, flags);
+  if (res <= 0)
+  {
+    return res;
+  }
+
+  for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr; cmsg = CMSG_NXTHDR(&msg, cmsg))
+  {
+    if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPNS)
+    {
+      struct timespec stamp;
+      std::memcpy(&stamp, CMSG_DATA(cmsg), sizeof(stamp));
+      auto since_epoch = std::chrono::seconds(stamp.tv_sec) + std::chrono::nanoseconds(stamp.tv_nsec);
+      last_receive_time_ = std::chrono::system_clock::time_point(
+          std::chrono::duration_cast<std::chrono::system_clock::duration>(since_epoch));
+      return res;
+    }
+  }
+
+  // No kernel timestamp available, so use the time the data got to user space instead.
+  last_receive_time_ = std::chrono::system_clock::now();
+  return res;
 }
 
 bool TCPSocket::write(const uint8_t* buf, const size_t buf_len, size_t& written)
@@ -209,5 +472,35 @@ void TCPSocket::setReceiveTimeout(const timeval& timeout)
   }
 }
 
+void TCPSocket::setKeepaliveConfig(const KeepaliveConfig& config)
+{
+  keepalive_ = config;
+
+  if (state_ == SocketState::Connected)
+  {
+    applyKeepaliveConfig(socket_fd_, keepalive_);
+  }
+}
+
+void TCPSocket::setBusyPolling(const BusyPollConfig& config)
+{
+  busy_poll_ = config;
+
+  if (state_ == SocketState::Connected)
+  {
+    applyBusyPollOptions(socket_fd_);
+  }
+}
+
+BusyPollStatistics TCPSocket::getBusyPollStatistics() const
+{
+  BusyPollStatistics stats;
+  stats.spin_iterations = spin_iterations_.load(std::memory_order_relaxed);
+  stats.spin_reads = spin_reads_.load(std::memory_order_relaxed);
+  stats.blocking_reads = blocking_reads_.load(std::memory_order_relaxed);
+  stats.packages = packages_read_.load(std::memory_order_relaxed);
+  return stats;
+}
+
 }  // namespace comm
 }  // namespace urcl
@@ -0,0 +1,204 @@
+// this is for emacs file handling -*- mode: c++; indent-tabs-mode: nil -*-
+
+// -- BEGIN LICENSE BLOCK ----------------------------------------------
+// Copyright 2026 Universal Robots A/S
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -- END LICENSE BLOCK ------------------------------------------------
+
+//----------------------------------------------------------------------
+/*!\file
+ *
+ * \date    2026-10-19
+ *
+ */
+//----------------------------------------------------------------------
+
+
+#include "ur_client_library/control/phase_locked_scheduler.h"
+
+#include <cmath>
+
+namespace urcl
+{
+namespace control
+{
+PhaseLockedScheduler::PhaseLockedScheduler(const std::chrono::nanoseconds period, const std::chrono::nanoseconds lead)
+  : locked_(false)
+  , period_(period.count())
+  , nominal_period_(period.count())
+  , lead_(lead)
+  , running_(false)
+  , margin_sum_(0)
+{
+}
+
+PhaseLockedScheduler::~PhaseLockedScheduler()
+{
+  stop();
+}
+
+void PhaseLockedScheduler::onPackage(const std::chrono::system_clock::time_point arrival)
+{
+  if (arrival == std::chrono::system_clock::time_point())
+  {
+    // No receive time available, e.g. because the socket doesn't support timestamping.
+    onPackage(std::chrono::steady_clock::now());
+    return;
+  }
+  const auto age = std::chrono::system_clock::now() - arrival;
+  onPackage(std::chrono::steady_clock::now() - std::chrono::duration_cast<std::chrono::steady_clock::duration>(age));
+}
+
+void PhaseLockedScheduler::onPackage(const std::chrono::steady_clock::time_point arrival)
+{
+  {
+    std::lock_guard<std::mutex> lk(mutex_);
+    if (!locked_)
+    {
+      reference_ = arrival;
+      locked_ = true;
+    }
+    else
+    {
+      // Packages might have been lost, so the number of elapsed cycles is estimated first.
+      const double elapsed = std::chrono::duration<double, std::nano>(arrival - reference_).count();
+      const double cycles = std::round(elapsed / period_);
+      if (cycles < 1.0)
+      {
+        return;
+      }
+      const double error = elapsed - cycles * period_;
+      reference_ += std::chrono::nanoseconds(static_cast<int64_t>(cycles * period_ + PHASE_GAIN * error));
+      period_ += FREQUENCY_GAIN * error / cycles;
+    }
+  }
+  locked_cv_.notify_all();
+}
+
+void PhaseLockedScheduler::reset()
+{
+  std::lock_guard<std::mutex> lk(mutex_);
+  locked_ = false;
+  period_ = nominal_period_;
+}
+
+std::chrono::steady_clock::time_point
+PhaseLockedScheduler::nextTick(const std::chrono::steady_clock::time_point after) const
+{
+  const double elapsed = std::chrono::duration<double, std::nano>(after - reference_).count();
+  const double cycles = std::floor(elapsed / period_) + 1.0;
+  return reference_ + std::chrono::nanoseconds(static_cast<int64_t>(cycles * period_));
+}
+
+bool PhaseLockedScheduler::predictTick(const std::chrono::steady_clock::time_point after,
+                                       std::chrono::steady_clock::time_point& tick) const
+{
+  std::lock_guard<std::mutex> lk(mutex_);
+  if (!locked_)
+  {
+    return false;
+  }
+  tick = nextTick(after);
+  return true;
+}
+
+std::chrono::nanoseconds PhaseLockedScheduler::getPeriod() const
+{
+  std::lock_guard<std::mutex> lk(mutex_);
+  return std::chrono::nanoseconds(static_cast<int64_t>(period_));
+}
+
+PhaseMarginStatistics PhaseLockedScheduler::getStatistics() const
+{
+  std::lock_guard<std::mutex> lk(mutex_);
+  return statistics_;
+}
+
+void PhaseLockedScheduler::start(std::function<void()> callback)
+{
+  if (running_)
+  {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lk(mutex_);
+    statistics_ = PhaseMarginStatistics();
+    margin_sum_ = 0;
+  }
+  callback_ = callback;
+  running_ = true;
+  thread_ = std::thread(&PhaseLockedScheduler::run, this);
+}
+
+void PhaseLockedScheduler::stop()
+{
+  {
+    std::lock_guard<std::mutex> lk(mutex_);
+    running_ = false;
+  }
+  locked_cv_.notify_all();
+  if (thread_.joinable())
+  {
+    thread_.join();
+  }
+}
+
+void PhaseLockedScheduler::run()
+{
+  std::chrono::steady_clock::time_point last_tick;
+  while (running_)
+  {
+    std::chrono::steady_clock::time_point tick;
+    {
+      std::unique_lock<std::mutex> lk(mutex_);
+      locked_cv_.wait(lk, [this]() { return locked_ || !running_; });
+      if (!running_)
+      {
+        break;
+      }
+      // Never serve the same cycle twice, even if the phase estimate moved slightly.
+      const auto half_period = std::chrono::nanoseconds(static_cast<int64_t>(period_ / 2));
+      tick = nextTick(std::max(std::chrono::steady_clock::now() + lead_, last_tick + half_period));
+    }
+
+    std::this_thread::sleep_until(tick - lead_);
+    if (!running_)
+    {
+      break;
+    }
+    callback_();
+    const auto margin = std::chrono::duration_cast<std::chrono::nanoseconds>(tick - std::chrono::steady_clock::now());
+    last_tick = tick;
+
+    std::lock_guard<std::mutex> lk(mutex_);
+    if (statistics_.cycles == 0 || margin < statistics_.min_margin)
+    {
+      statistics_.min_margin = margin;
+    }
+    if (statistics_.cycles == 0 || margin > statistics_.max_margin)
+    {
+      statistics_.max_margin = margin;
+    }
+    if (margin.count() < 0)
+    {
+      ++statistics_.late;
+    }
+    ++statistics_.cycles;
+    margin_sum_ += margin.count();
+    statistics_.mean_margin = std::chrono::nanoseconds(margin_sum_ / static_cast<int64_t>(statistics_.cycles));
+  }
+}
+
+}  // namespace control
+}  // namespace urcl
@@ -28,13 +28,33 @@
 
 #include <ur_client_library/control/reverse_interface.h>
 
+#include <algorithm>
+#include <limits>
+
 namespace urcl
 {
 namespace control
 {
 ReverseInterface::ReverseInterface(uint32_t port, std::function<void(bool)> handle_program_state)
-  : client_fd_(-1), server_(port), handle_program_state_(handle_program_state), keepalive_count_(1)
+  : client_fd_(-1)
+  , server_(port)
+  , handle_program_state_(handle_program_state)
+  , keepalive_count_(1)
+  , message_fill_(0)
+  , last_servo_cycle_(-1)
+  , frame_size_(0)
+  , frame_pending_(0)
+  , frame_keepalive_(1)
+  , frame_mode_(comm::ControlMode::MODE_IDLE)
+  , sequence_(0)
+  , connection_time_(std::chrono::steady_clock::now())
+  , back_pressure_count_(0)
 {
+  std::fill(std::begin(frame_), std::end(frame_), 0);
+  frame_[0] = htobe32(frame_keepalive_);
+  frame_[7] = htobe32(toUnderlying(frame_mode_));
+  std::fill(std::begin(force_payload_), std::end(force_payload_), 0);
+  force_payload_[FORCE_PAYLOAD_LENGTH - 1] = htobe32(toUnderlying(ForceModeType::FRAME));
   handle_program_state_(false);
   server_.setMessageCallback(std::bind(&ReverseInterface::messageCallback, this, std::placeholders::_1,
                                        std::placeholders::_2, std::placeholders::_3));
@@ -50,33 +70,151 @@ bool ReverseInterface::write(const vector6d_t* positions, const comm::ControlMod
   {
     return false;
   }
-  uint8_t buffer[sizeof(int32_t) * 8];
-  uint8_t* b_pos = buffer;
+  std::lock_guard<std::mutex> lk(write_mutex_);
 
-  // The first element is always the keepalive signal.
-  int32_t val = htobe32(keepalive_count_);
-  b_pos += append(b_pos, val);
+  // The stream must not get out of sync, so the rest of a previous frame that couldn't be completed
+  // in time has to go first.
+  if (!flushPendingFrame(false))
+  {
+    return false;
+  }
+  if (frame_pending_ > 0)
+  {
+    ++back_pressure_count_;
+    return false;
+  }
+
+  return sendFrame(encodeFrame(positions, control_mode));
+}
+
+bool ReverseInterface::writeForceCommand(const vector6d_t& wrench, const vector6uint32_t& selection,
+                                         const vector6d_t& limits, const vector6d_t& task_frame,
+                                         const ForceModeType type)
+{
+  if (client_fd_ == -1)
+  {
+    return false;
+  }
+  std::lock_guard<std::mutex> lk(write_mutex_);
+
+  if (!flushPendingFrame(false))
+  {
+    return false;
+  }
+  if (frame_pending_ > 0)
+  {
+    ++back_pressure_count_;
+    return false;
+  }
+
+  for (size_t i = 0; i < 6; ++i)
+  {
+    force_payload_[i] = htobe32(static_cast<int32_t>(task_frame[i] * MULT_JOINTSTATE));
+    force_payload_[i + 6] = htobe32(static_cast<int32_t>(selection[i]));
+    force_payload_[i + 12] = htobe32(static_cast<int32_t>(limits[i] * MULT_JOINTSTATE));
+  }
+  force_payload_[18] = htobe32(toUnderlying(type));
+  return sendFrame(encodeFrame(&wrench, comm::ControlMode::MODE_FORCE));
+}
 
+size_t ReverseInterface::encodeFrame(const vector6d_t* positions, const comm::ControlMode control_mode)
+{
+  // Only fields that changed are encoded again.
+  if (keepalive_count_ != frame_keepalive_)
+  {
+    frame_keepalive_ = keepalive_count_;
+    frame_[0] = htobe32(frame_keepalive_);
+  }
   if (positions != nullptr)
   {
-    for (auto const& pos : *positions)
+    for (size_t i = 0; i < 6; ++i)
     {
-      int32_t val = static_cast<int32_t>(pos * MULT_JOINTSTATE);
-      val = htobe32(val);
-      b_pos += append(b_pos, val);
+      frame_[i + 1] = htobe32(static_cast<int32_t>((*positions)[i] * MULT_JOINTSTATE));
     }
   }
   else
   {
-    b_pos += 6 * sizeof(int32_t);
+    std::fill(frame_ + 1, frame_ + 7, 0);
+  }
+  if (control_mode != frame_mode_)
+  {
+    frame_mode_ = control_mode;
+    frame_[7] = htobe32(toUnderlying(frame_mode_));
   }
 
-  val = htobe32(toUnderlying(control_mode));
-  b_pos += append(b_pos, val);
+  // The robot expects the force mode parameters after every force mode frame, so the last ones are
+  // repeated.
+  if (control_mode == comm::ControlMode::MODE_FORCE)
+  {
+    std::copy(std::begin(force_payload_), std::end(force_payload_), frame_ + FRAME_LENGTH);
+    return FRAME_LENGTH + FORCE_PAYLOAD_LENGTH;
+  }
+  if (control_mode != comm::ControlMode::MODE_SERVOJ_TIMESTAMPED)
+  {
+    return FRAME_LENGTH;
+  }
+
+  // Sequence numbers are positive, 0 marks messages without a setpoint. Send times are relative to
+  // the connection and wrap after about 35 minutes, which the robot detects as a clock jump.
+  sequence_ = sequence_ < std::numeric_limits<int32_t>::max() ? sequence_ + 1 : 1;
+  const auto now = std::chrono::steady_clock::now();
+  const int64_t stamp = std::chrono::duration_cast<std::chrono::microseconds>(now - connection_time_).count();
+  frame_[FRAME_LENGTH] = htobe32(sequence_);
+  frame_[FRAME_LENGTH + 1] = htobe32(static_cast<int32_t>(stamp % std::numeric_limits<int32_t>::max()));
 
+  SentSetpoint& sent = sent_setpoints_[sequence_ % SEQUENCE_HISTORY];
+  sent.sequence = 0;
+  sent.time = std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count();
+  sent.sequence = sequence_;
+  return FRAME_LENGTH + STAMP_PAYLOAD_LENGTH;
+}
+
+bool ReverseInterface::sendFrame(const size_t length)
+{
   size_t written;
+  frame_size_ = length * sizeof(int32_t);
+  if (!server_.writeNonBlocking(client_fd_, reinterpret_cast<const uint8_t*>(frame_), frame_size_, written))
+  {
+    return false;
+  }
+  if (written == 0)
+  {
+    // Nothing has been sent, so the command can be dropped without the stream getting out of sync.
+    ++back_pressure_count_;
+    return false;
+  }
 
-  return server_.write(client_fd_, buffer, sizeof(buffer), written);
+  // The robot only waits for the rest of a frame for a short time, so it is sent right away.
+  frame_pending_ = frame_size_ - written;
+  if (!flushPendingFrame(false))
+  {
+    return false;
+  }
+  if (frame_pending_ > 0)
+  {
+    ++back_pressure_count_;
+    return false;
+  }
+  return true;
+}
+
+bool ReverseInterface::flushPendingFrame(const bool blocking)
+{
+  if (frame_pending_ == 0)
+  {
+    return true;
+  }
+  const uint8_t* rest = reinterpret_cast<const uint8_t*>(frame_) + frame_size_ - frame_pending_;
+  size_t written;
+  const bool success = blocking ?
+                           server_.write(client_fd_, rest, frame_pending_, written) :
+                           server_.writeNonBlocking(client_fd_, rest, frame_pending_, written, ROBOT_READ_TIMEOUT);
+  if (!success)
+  {
+    return false;
+  }
+  frame_pending_ -= written;
+  return true;
 }
 
 bool ReverseInterface::writeTrajectoryControlMessage(const TrajectoryControlMessage trajectory_action,
@@ -86,7 +224,13 @@ bool ReverseInterface::writeTrajectoryControlMessage(const TrajectoryControlMess
   {
     return false;
   }
-  uint8_t buffer[sizeof(int32_t) * 8];
+  std::lock_guard<std::mutex> lk(write_mutex_);
+  if (!flushPendingFrame(true))
+  {
+    return false;
+  }
+
+  uint8_t buffer[sizeof(int32_t) * FRAME_LENGTH];
   uint8_t* b_pos = buffer;
 
   // The first element is always the keepalive signal.
@@ -120,6 +264,7 @@ void ReverseInterface::connectionCallback(const int filedescriptor)
   {
     URCL_LOG_INFO("Robot connected to reverse interface. Ready to receive control commands.");
     client_fd_ = filedescriptor;
+    connection_time_ = std::chrono::steady_clock::now();
     handle_program_state_(true);
   }
   else
@@ -132,14 +277,81 @@ void ReverseInterface::connectionCallback(const int filedescriptor)
 void ReverseInterface::disconnectionCallback(const int filedescriptor)
 {
   URCL_LOG_INFO("Connection to reverse interface dropped.", filedescriptor);
-  client_fd_ = -1;
+  {
+    // A write might still be in progress, it must not continue a frame on the next connection.
+    std::lock_guard<std::mutex> lk(write_mutex_);
+    client_fd_ = -1;
+    frame_pending_ = 0;
+  }
+  message_fill_ = 0;
+  {
+    std::lock_guard<std::mutex> lk(telemetry_mutex_);
+    last_servo_cycle_ = -1;
+  }
   handle_program_state_(false);
 }
 
 void ReverseInterface::messageCallback(const int filedescriptor, char* buffer, int nbytesrecv)
 {
-  URCL_LOG_WARN("Message on ReverseInterface received. The reverse interface currently does not support any message "
-                "handling. This message will be ignored.");
+  // The robot reports every servo cycle. Reports can be split or coalesced by TCP.
+  for (int i = 0; i < nbytesrecv; ++i)
+  {
+    message_buffer_[message_fill_++] = buffer[i];
+    if (message_fill_ == TELEMETRY_MESSAGE_SIZE)
+    {
+      uint32_t report;
+      std::memcpy(&report, message_buffer_, sizeof(report));
+      report = be32toh(report);
+      handleServoCycle((report >> 24) & 0x7f, (report >> 22) & 0x3, (report >> 16) & 0x3f, report & 0xffff);
+      message_fill_ = 0;
+    }
+  }
+}
+
+void ReverseInterface::handleServoCycle(const int32_t cycle, const int32_t status, const int32_t extrapolations,
+                                        const int32_t sequence)
+{
+  const auto now = std::chrono::steady_clock::now();
+  std::lock_guard<std::mutex> lk(telemetry_mutex_);
+
+  // The counter restarts with each program run, which opens a new connection.
+  const int32_t gap = (cycle - last_servo_cycle_ + TELEMETRY_CYCLE_RANGE) % TELEMETRY_CYCLE_RANGE;
+  if (last_servo_cycle_ >= 0 && gap > 0)
+  {
+    telemetry_.lost_reports += gap - 1;
+    const size_t bin = (now - last_report_) / ServoTelemetry::INTERVAL_BIN_WIDTH;
+    ++telemetry_.interval_histogram[std::min(bin, ServoTelemetry::INTERVAL_BINS - 1)];
+  }
+  last_servo_cycle_ = cycle;
+  last_report_ = now;
+
+  ++telemetry_.cycles;
+  if (status != SETPOINT_NEW)
+  {
+    ++telemetry_.misses;
+  }
+  if (status == SETPOINT_STALE)
+  {
+    ++telemetry_.stale_setpoints;
+  }
+  const uint32_t count = extrapolations > 0 ? extrapolations : 0;
+  telemetry_.max_consecutive_extrapolations = std::max(telemetry_.max_consecutive_extrapolations, count);
+  ++telemetry_.extrapolation_histogram[std::min<size_t>(count, ServoTelemetry::EXTRAPOLATION_BINS - 1)];
+
+  // The send time is only known while the sequence number is still in the history. Only the lower
+  // bits of the sequence number are reported.
+  const SentSetpoint& sent = sent_setpoints_[sequence % SEQUENCE_HISTORY];
+  const int32_t sent_sequence = sent.sequence;
+  const std::chrono::steady_clock::time_point sent_time{ std::chrono::duration_cast<
+      std::chrono::steady_clock::duration>(std::chrono::nanoseconds(sent.time)) };
+  if (sequence > 0 && sent_sequence % TELEMETRY_SEQUENCE_RANGE == sequence && sent.sequence == sent_sequence)
+  {
+    const auto age = std::chrono::duration_cast<std::chrono::microseconds>(now - sent_time);
+    telemetry_.last_setpoint_age = age;
+    telemetry_.max_setpoint_age = std::max(telemetry_.max_setpoint_age, age);
+    const size_t bin = age / ServoTelemetry::AGE_BIN_WIDTH;
+    ++telemetry_.setpoint_age_histogram[std::min(bin, ServoTelemetry::AGE_BINS - 1)];
+  }
 }
 }  // namespace control
 }  // namespace urcl
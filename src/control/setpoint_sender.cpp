@@ -0,0 +1,160 @@
+// this is for emacs file handling -*- mode: c++; indent-tabs-mode: nil -*-
+
+// -- BEGIN LICENSE BLOCK ----------------------------------------------
+// Copyright 2026 Universal Robots A/S
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -- END LICENSE BLOCK ------------------------------------------------
+
+//----------------------------------------------------------------------
+/*!\file
+ *
+ * \date    2026-10-19
+ *
+ */
+//----------------------------------------------------------------------
+
+
+#include "ur_client_library/control/setpoint_sender.h"
+#include "ur_client_library/log.h"
+
+#include <algorithm>
+
+#include <pthread.h>
+#include <sys/mman.h>
+
+namespace urcl
+{
+namespace control
+{
+SetpointSender::SetpointSender(ReverseInterface& reverse_interface, const std::chrono::nanoseconds period,
+                               const uint32_t keepalive_cycles)
+  : reverse_interface_(reverse_interface)
+  , period_(period)
+  , keepalive_cycles_(keepalive_cycles)
+  , cycles_without_setpoint_(0)
+  , running_(false)
+  , sent_(0)
+  , keepalives_(0)
+{
+  if (keepalive_cycles_ == 0)
+  {
+    keepalive_cycles_ = std::max<uint32_t>(ReverseInterface::ROBOT_READ_TIMEOUT / 2 / period_, 1);
+  }
+  else if (keepalive_cycles_ * period_ >= ReverseInterface::ROBOT_READ_TIMEOUT)
+  {
+    URCL_LOG_WARN("Setpoint sender: A keepalive every %u cycles is too slow for the robot's read timeout of %ld ms",
+                  keepalive_cycles_, ReverseInterface::ROBOT_READ_TIMEOUT.count());
+  }
+}
+
+SetpointSender::~SetpointSender()
+{
+  stop();
+}
+
+void SetpointSender::start(const RealtimeConfig& config)
+{
+  if (running_)
+  {
+    return;
+  }
+  running_ = true;
+  thread_ = std::thread(&SetpointSender::run, this, config);
+}
+
+void SetpointSender::stop()
+{
+  running_ = false;
+  if (thread_.joinable())
+  {
+    thread_.join();
+  }
+}
+
+void SetpointSender::publish(const vector6d_t& values, const comm::ControlMode control_mode)
+{
+  mailbox_.publish({ values, control_mode });
+}
+
+void SetpointSender::applyRealtimeConfig(const RealtimeConfig& config)
+{
+  if (config.lock_memory && mlockall(MCL_CURRENT | MCL_FUTURE) != 0)
+  {
+    URCL_LOG_WARN("Setpoint sender: Could not lock memory, page faults might delay sending setpoints");
+  }
+
+  if (config.cpu >= 0)
+  {
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(config.cpu, &cpuset);
+    int ret = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
+    if (ret != 0)
+    {
+      URCL_LOG_ERROR("Unsuccessful in pinning setpoint sender thread to CPU %d. Error code: %d", config.cpu, ret);
+    }
+  }
+
+  if (config.priority != 0)
+  {
+    struct sched_param params;
+    params.sched_priority = config.priority > 0 ? config.priority : sched_get_priority_max(SCHED_FIFO);
+    int ret = pthread_setschedparam(pthread_self(), SCHED_FIFO, &params);
+    if (ret != 0)
+    {
+      URCL_LOG_WARN("Setpoint sender: Could not set SCHED_FIFO priority %d. Error code: %d", params.sched_priority,
+                    ret);
+    }
+  }
+}
+
+void SetpointSender::sendCycle()
+{
+  if (mailbox_.fetch(setpoint_))
+  {
+    cycles_without_setpoint_ = 0;
+    reverse_interface_.write(&setpoint_.values, setpoint_.mode);
+    ++sent_;
+  }
+  else if (++cycles_without_setpoint_ >= keepalive_cycles_)
+  {
+    // Repeating the last setpoint would make the robot execute it again.
+    cycles_without_setpoint_ = 0;
+    reverse_interface_.write(nullptr, comm::ControlMode::MODE_KEEPALIVE);
+    ++keepalives_;
+  }
+}
+
+void SetpointSender::run(const RealtimeConfig config)
+{
+  applyRealtimeConfig(config);
+
+  auto next_cycle = std::chrono::steady_clock::now();
+  while (running_)
+  {
+    sendCycle();
+
+    next_cycle += period_;
+    const auto now = std::chrono::steady_clock::now();
+    if (next_cycle < now)
+    {
+      // Missed at least one cycle, don't try to catch up with a burst of writes.
+      next_cycle = now;
+    }
+    std::this_thread::sleep_until(next_cycle);
+  }
+}
+
+}  // namespace control
+}  // namespace urcl
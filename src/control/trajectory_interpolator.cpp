@@ -0,0 +1,151 @@
+// this is for emacs file handling -*- mode: c++; indent-tabs-mode: nil -*-
+
+// -- BEGIN LICENSE BLOCK ----------------------------------------------
+// Copyright 2026 Universal Robots A/S
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -- END LICENSE BLOCK ------------------------------------------------
+
+//----------------------------------------------------------------------
+/*!\file
+ *
+ * \date    2026-10-19
+ *
+ */
+//----------------------------------------------------------------------
+
+
+#include "ur_client_library/control/trajectory_interpolator.h"
+
+namespace urcl
+{
+namespace control
+{
+TrajectoryInterpolator::TrajectoryInterpolator(const double sample_period, const size_t max_waypoints)
+  : sample_period_(sample_period)
+  , time_(0.0)
+  , started_(false)
+  , steps_(0)
+  , waypoints_(max_waypoints > 2 ? max_waypoints : 2)
+  , head_(0)
+  , size_(0)
+{
+}
+
+bool TrajectoryInterpolator::addWaypoint(const vector6d_t& position, const double time)
+{
+  if (size_ == waypoints_.size())
+  {
+    return false;
+  }
+  if (size_ > 0 && time <= at(size_ - 1).time)
+  {
+    return false;
+  }
+  waypoints_[(head_ + size_) % waypoints_.size()] = { position, time };
+  ++size_;
+  return true;
+}
+
+void TrajectoryInterpolator::reset()
+{
+  time_ = 0.0;
+  started_ = false;
+  steps_ = 0;
+  head_ = 0;
+  size_ = 0;
+}
+
+void TrajectoryInterpolator::tangent(const size_t index, vector6d_t& tangent) const
+{
+  // The trajectory starts and ends at rest
+  if (index == 0 || index + 1 >= size_)
+  {
+    tangent.fill(0.0);
+    return;
+  }
+  const Waypoint& prev = at(index - 1);
+  const Waypoint& next = at(index + 1);
+  const double inv_dt = 1.0 / (next.time - prev.time);
+  for (size_t j = 0; j < 6; ++j)
+  {
+    tangent[j] = (next.position[j] - prev.position[j]) * inv_dt;
+  }
+}
+
+bool TrajectoryInterpolator::evaluate(const double time, vector6d_t& setpoint) const
+{
+  if (size_ == 0)
+  {
+    return false;
+  }
+  if (time <= at(0).time)
+  {
+    setpoint = at(0).position;
+    return true;
+  }
+  if (time > at(size_ - 1).time)
+  {
+    setpoint = at(size_ - 1).position;
+    return false;
+  }
+
+  size_t i = 0;
+  while (at(i + 1).time < time)
+  {
+    ++i;
+  }
+  const Waypoint& p0 = at(i);
+  const Waypoint& p1 = at(i + 1);
+  vector6d_t m0;
+  vector6d_t m1;
+  tangent(i, m0);
+  tangent(i + 1, m1);
+
+  // Hermite basis functions, evaluated once for all joints
+  const double dt = p1.time - p0.time;
+  const double s = (time - p0.time) / dt;
+  const double s2 = s * s;
+  const double s3 = s2 * s;
+  const double h00 = 2 * s3 - 3 * s2 + 1;
+  const double h10 = (s3 - 2 * s2 + s) * dt;
+  const double h01 = -2 * s3 + 3 * s2;
+  const double h11 = (s3 - s2) * dt;
+  for (size_t j = 0; j < 6; ++j)
+  {
+    setpoint[j] = h00 * p0.position[j] + h10 * m0[j] + h01 * p1.position[j] + h11 * m1[j];
+  }
+  return true;
+}
+
+bool TrajectoryInterpolator::next(vector6d_t& setpoint)
+{
+  // Computed from the step count, so that the time doesn't drift by accumulating rounding errors.
+  time_ = started_ ? ++steps_ * sample_period_ : 0.0;
+  started_ = true;
+  dropPassedWaypoints();
+  return evaluate(time_, setpoint);
+}
+
+void TrajectoryInterpolator::dropPassedWaypoints()
+{
+  // The segment currently evaluated needs the waypoint before it for its start tangent.
+  while (size_ > 3 && at(2).time <= time_)
+  {
+    head_ = (head_ + 1) % waypoints_.size();
+    --size_;
+  }
+}
+
+}  // namespace control
+}  // namespace urcl
@@ -28,11 +28,17 @@
 
 #include <ur_client_library/control/trajectory_point_interface.h>
 
+#include <algorithm>
+
 namespace urcl
 {
 namespace control
 {
-TrajectoryPointInterface::TrajectoryPointInterface(uint32_t port) : ReverseInterface(port, [](bool foo) { return foo; })
+TrajectoryPointInterface::TrajectoryPointInterface(uint32_t port)
+  : ReverseInterface(port, [](bool foo) { return foo; })
+  , message_fill_(0)
+  , consumed_points_(0)
+  , trajectory_ended_(false)
 {
 }
 
@@ -85,6 +91,132 @@ bool TrajectoryPointInterface::writeTrajectoryPoint(const vector6d_t* positions,
   return server_.write(client_fd_, buffer, sizeof(buffer), written);
 }
 
+bool TrajectoryPointInterface::writeTrajectoryPoints(const vector6d_t* positions, const float* goal_times,
+                                                     const float* blend_radii, const size_t num_points,
+                                                     const bool cartesian)
+{
+  if (client_fd_ == -1 || positions == nullptr || goal_times == nullptr)
+  {
+    return false;
+  }
+  if (num_points == 0)
+  {
+    return true;
+  }
+
+  // The buffer is kept between calls, so uploading trajectories doesn't allocate every time.
+  batch_buffer_.resize(num_points * MESSAGE_LENGTH);
+  const int32_t point_type = cartesian ? CARTESIAN_POINT : JOINT_POINT;
+  for (size_t i = 0; i < num_points; ++i)
+  {
+    encodePoint(&batch_buffer_[i * MESSAGE_LENGTH], positions[i], goal_times[i],
+                blend_radii != nullptr ? blend_radii[i] : 0.0f, point_type);
+  }
+  return sendBatch();
+}
+
+bool TrajectoryPointInterface::writeTrajectoryPoints(const TrajectoryPoint* points, const size_t num_points,
+                                                     const bool cartesian)
+{
+  if (client_fd_ == -1 || points == nullptr)
+  {
+    return false;
+  }
+  if (num_points == 0)
+  {
+    return true;
+  }
+
+  batch_buffer_.resize(num_points * MESSAGE_LENGTH);
+  const int32_t point_type = cartesian ? CARTESIAN_POINT : JOINT_POINT;
+  for (size_t i = 0; i < num_points; ++i)
+  {
+    encodePoint(&batch_buffer_[i * MESSAGE_LENGTH], points[i].positions, points[i].goal_time, points[i].blend_radius,
+                point_type);
+  }
+  return sendBatch();
+}
+
+void TrajectoryPointInterface::encodePoint(int32_t* buffer, const vector6d_t& positions, const float goal_time,
+                                           const float blend_radius, const int32_t point_type)
+{
+  for (size_t j = 0; j < 6; ++j)
+  {
+    buffer[j] = static_cast<int32_t>(positions[j] * MULT_JOINTSTATE);
+  }
+  buffer[6] = static_cast<int32_t>(goal_time * MULT_TIME);
+  buffer[7] = static_cast<int32_t>(blend_radius * MULT_TIME);
+  buffer[8] = point_type;
+}
+
+bool TrajectoryPointInterface::sendBatch()
+{
+  // Separate pass, so that both the encoding loop and this one are simple enough to be vectorized
+  for (auto& val : batch_buffer_)
+  {
+    val = htobe32(val);
+  }
+
+  size_t written;
+  return server_.write(client_fd_, reinterpret_cast<const uint8_t*>(batch_buffer_.data()),
+                       batch_buffer_.size() * sizeof(int32_t), written);
+}
+
+bool TrajectoryPointInterface::streamTrajectory(const vector6d_t* positions, const float* goal_times,
+                                                const float* blend_radii, const size_t num_points,
+                                                const bool cartesian, const size_t window)
+{
+  if (window == 0)
+  {
+    URCL_LOG_ERROR("Cannot stream a trajectory with a window of 0 points");
+    return false;
+  }
+
+  size_t sent = 0;
+  while (sent < num_points)
+  {
+    size_t in_flight;
+    {
+      std::unique_lock<std::mutex> lk(progress_mutex_);
+      // Waiting in slices, so that a dropped connection is noticed as well.
+      progress_cv_.wait_for(lk, std::chrono::milliseconds(100), [this, sent, window]() {
+        return trajectory_ended_ || sent - std::min<size_t>(consumed_points_, sent) < window;
+      });
+      if (trajectory_ended_)
+      {
+        URCL_LOG_WARN("Trajectory ended after %zu of %zu points were streamed", sent, num_points);
+        return false;
+      }
+      in_flight = sent - std::min<size_t>(consumed_points_, sent);
+    }
+    if (client_fd_ == -1)
+    {
+      URCL_LOG_ERROR("Robot disconnected from trajectory interface while streaming a trajectory");
+      return false;
+    }
+    if (in_flight >= window)
+    {
+      continue;
+    }
+
+    const size_t count = std::min(window - in_flight, num_points - sent);
+    if (!writeTrajectoryPoints(positions + sent, goal_times + sent, blend_radii ? blend_radii + sent : nullptr, count,
+                               cartesian))
+    {
+      return false;
+    }
+    sent += count;
+  }
+  return true;
+}
+
+void TrajectoryPointInterface::resetProgress()
+{
+  std::lock_guard<std::mutex> lk(progress_mutex_);
+  consumed_points_ = 0;
+  trajectory_ended_ = false;
+}
+
 void TrajectoryPointInterface::connectionCallback(const int filedescriptor)
 {
   if (client_fd_ < 0)
@@ -103,28 +235,67 @@ void TrajectoryPointInterface::disconnectionCallback(const int filedescriptor)
 {
   URCL_LOG_DEBUG("Connection to trajectory interface dropped.", filedescriptor);
   client_fd_ = -1;
+  message_fill_ = 0;
+  progress_cv_.notify_all();
 }
 
 void TrajectoryPointInterface::messageCallback(const int filedescriptor, char* buffer, int nbytesrecv)
 {
-  if (nbytesrecv == 4)
+  // Messages can be split or coalesced by TCP, so they are reassembled here.
+  for (int i = 0; i < nbytesrecv; ++i)
   {
-    int32_t* status = reinterpret_cast<int*>(buffer);
-    URCL_LOG_DEBUG("Received message %d on TrajectoryPointInterface", be32toh(*status));
+    message_buffer_[message_fill_++] = buffer[i];
+    if (message_fill_ == ROBOT_MESSAGE_SIZE)
+    {
+      int32_t type;
+      int32_t value;
+      std::memcpy(&type, message_buffer_, sizeof(int32_t));
+      std::memcpy(&value, message_buffer_ + sizeof(int32_t), sizeof(int32_t));
+      handleRobotMessage(static_cast<TrajectoryMessageType>(be32toh(type)), be32toh(value));
+      message_fill_ = 0;
+    }
+  }
+}
 
-    if (handle_trajectory_end_)
+void TrajectoryPointInterface::handleRobotMessage(const TrajectoryMessageType type, const int32_t value)
+{
+  switch (type)
+  {
+    case TrajectoryMessageType::TRAJECTORY_MESSAGE_PROGRESS:
     {
-      handle_trajectory_end_(static_cast<TrajectoryResult>(be32toh(*status)));
+      {
+        std::lock_guard<std::mutex> lk(progress_mutex_);
+        consumed_points_ = static_cast<uint32_t>(value);
+      }
+      progress_cv_.notify_all();
+      if (handle_trajectory_progress_)
+      {
+        handle_trajectory_progress_(static_cast<uint32_t>(value));
+      }
+      break;
     }
-    else
+    case TrajectoryMessageType::TRAJECTORY_MESSAGE_RESULT:
     {
-      URCL_LOG_DEBUG("Trajectory execution finished with result %d, but no callback was given.");
+      URCL_LOG_DEBUG("Received trajectory result %d on TrajectoryPointInterface", value);
+      {
+        std::lock_guard<std::mutex> lk(progress_mutex_);
+        trajectory_ended_ = true;
+      }
+      progress_cv_.notify_all();
+      if (handle_trajectory_end_)
+      {
+        handle_trajectory_end_(static_cast<TrajectoryResult>(value));
+      }
+      else
+      {
+        URCL_LOG_DEBUG("Trajectory execution finished with result %d, but no callback was given.", value);
+      }
+      break;
     }
-  }
-  else
-  {
-    URCL_LOG_WARN("Received %d bytes on TrajectoryPointInterface. Expecting 4 bytes, so ignoring this message",
-                  nbytesrecv);
+    default:
+      URCL_LOG_WARN("Received unknown message type %d on TrajectoryPointInterface, ignoring it",
+                    static_cast<int32_t>(type));
+      break;
   }
 }
 }  // namespace control
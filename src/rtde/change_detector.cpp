@@ -0,0 +1,193 @@
+// this is for emacs file handling -*- mode: c++; indent-tabs-mode: nil -*-
+
+// -- BEGIN LICENSE BLOCK ----------------------------------------------
+// Copyright 2026 Universal Robots A/S
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -- END LICENSE BLOCK ------------------------------------------------
+
+//----------------------------------------------------------------------
+/*!\file
+ *
+ * \date    2026-10-19
+ *
+ */
+//----------------------------------------------------------------------
+
+
+#include "ur_client_library/rtde/change_detector.h"
+#include "ur_client_library/exceptions.h"
+
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+namespace urcl
+{
+namespace rtde_interface
+{
+ChangeDetector::ChangeDetector(const std::vector<std::string>& recipe) : has_previous_(false)
+{
+  DataPackage reference(recipe);
+  reference.initEmpty();
+
+  size_t offset = 0;
+  for (const auto& name : recipe)
+  {
+    DataPackage::_rtde_type_variant value;
+    if (!reference.getData(name, value))
+    {
+      throw UrException("Unknown RTDE field '" + name + "' in change detector recipe");
+    }
+    if (std::holds_alternative<std::string>(value))
+    {
+      throw UrException("String field '" + name + "' is not supported by the change detector");
+    }
+
+    const size_t bytes = std::visit([](auto&& v) { return sizeof(v); }, value);
+    const bool integral =
+        std::visit([](auto&& v) { return std::is_integral<std::decay_t<decltype(v)>>::value; }, value);
+    const size_t words = (bytes + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+    layout_.push_back({ name, offset, words, integral, value.index(), false, 0 });
+    offset += words;
+  }
+
+  previous_.resize(offset, 0);
+  changed_.resize((layout_.size() + 63) / 64, 0);
+  edges_.reserve(layout_.size());
+}
+
+size_t ChangeDetector::getFieldIndex(const std::string& field) const
+{
+  auto it = std::find_if(layout_.begin(), layout_.end(), [&field](const Layout& l) { return l.name == field; });
+  if (it == layout_.end())
+  {
+    throw UrException("Field '" + field + "' is not part of the change detector recipe");
+  }
+  return it - layout_.begin();
+}
+
+ChangeDetector::FieldMask ChangeDetector::makeMask(const std::vector<std::string>& fields) const
+{
+  FieldMask mask(changed_.size(), 0);
+  for (const auto& field : fields)
+  {
+    const size_t index = getFieldIndex(field);
+    mask[index / 64] |= uint64_t(1) << (index % 64);
+  }
+  return mask;
+}
+
+void ChangeDetector::subscribe(const FieldMask& mask, Subscriber subscriber)
+{
+  if (mask.size() != changed_.size())
+  {
+    throw UrException("Field mask has " + std::to_string(mask.size()) +
+                      " words, but the change detector recipe needs " + std::to_string(changed_.size()));
+  }
+  subscribers_.emplace_back(mask, subscriber);
+}
+
+bool ChangeDetector::hasChanged(const std::string& field) const
+{
+  const size_t index = getFieldIndex(field);
+  return (changed_[index / 64] >> (index % 64)) & 1;
+}
+
+void ChangeDetector::resolve(const DataPackage& package)
+{
+  recipe_ = package.getRecipe();
+  for (auto& field : layout_)
+  {
+    field.present = package.findField(field.name, field.index);
+  }
+}
+
+bool ChangeDetector::update(DataPackage& package)
+{
+  std::fill(changed_.begin(), changed_.end(), 0);
+  edges_.clear();
+
+  if (package.getRecipe() != recipe_)
+  {
+    resolve(package);
+  }
+
+  // Each field is packed into zero-padded words and compared against the previous sample right
+  // away, so the sample is only traversed once.
+  uint64_t words[(sizeof(DataPackage::_rtde_type_variant) + sizeof(uint64_t) - 1) / sizeof(uint64_t)];
+  bool any_change = false;
+  for (size_t i = 0; i < layout_.size(); ++i)
+  {
+    const Layout& field = layout_[i];
+    const DataPackage::_rtde_type_variant* value = field.present ? package.getDataAt(field.index) : nullptr;
+    if (value == nullptr || value->index() != field.type)
+    {
+      // A field missing from the package keeps its previous value.
+      continue;
+    }
+
+    words[field.words - 1] = 0;
+    std::visit(
+        [&words](auto&& v) {
+          if constexpr (!std::is_same<std::decay_t<decltype(v)>, std::string>::value)
+          {
+            std::memcpy(words, &v, sizeof(v));
+          }
+        },
+        *value);
+
+    uint64_t* prev = &previous_[field.offset];
+    uint64_t field_diff = 0;
+    for (size_t w = 0; w < field.words; ++w)
+    {
+      field_diff |= prev[w] ^ words[w];
+    }
+    if (field_diff != 0 && has_previous_)
+    {
+      any_change = true;
+      changed_[i / 64] |= uint64_t(1) << (i % 64);
+      // Integral fields fit into a single word
+      if (field.integral)
+      {
+        edges_.push_back({ i, ~prev[0] & words[0], prev[0] & ~words[0] });
+      }
+    }
+    std::copy(words, words + field.words, prev);
+  }
+
+  if (!has_previous_)
+  {
+    has_previous_ = true;
+    return false;
+  }
+
+  if (any_change)
+  {
+    for (const auto& subscriber : subscribers_)
+    {
+      for (size_t w = 0; w < changed_.size(); ++w)
+      {
+        if (subscriber.first[w] & changed_[w])
+        {
+          subscriber.second(changed_, edges_);
+          break;
+        }
+      }
+    }
+  }
+  return any_change;
+}
+
+}  // namespace rtde_interface
+}  // namespace urcl
@@ -0,0 +1,223 @@
+// this is for emacs file handling -*- mode: c++; indent-tabs-mode: nil -*-
+
+// -- BEGIN LICENSE BLOCK ----------------------------------------------
+// Copyright 2026 Universal Robots A/S
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -- END LICENSE BLOCK ------------------------------------------------
+
+//----------------------------------------------------------------------
+/*!\file
+ *
+ * \date    2026-10-19
+ *
+ */
+//----------------------------------------------------------------------
+
+
+#include "ur_client_library/rtde/clock_estimator.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace urcl
+{
+namespace rtde_interface
+{
+ClockEstimator::ClockEstimator(const size_t window_size, const size_t num_windows)
+  : window_size_(std::max<size_t>(window_size, 1))
+  , num_windows_(std::max<size_t>(num_windows, 2))
+  , has_timestamp_(false)
+  , timestamp_index_(0)
+{
+  minima_.reserve(num_windows_);
+  reset();
+}
+
+void ClockEstimator::reset()
+{
+  std::lock_guard<std::mutex> lk(mutex_);
+  has_reference_ = false;
+  window_count_ = 0;
+  last_robot_time_ = 0.0;
+  minima_.clear();
+  next_minimum_ = 0;
+  valid_ = false;
+  robot_reference_ = 0.0;
+  intercept_ = 0.0;
+  slope_ = 0.0;
+  error_bound_ = 0.0;
+}
+
+bool ClockEstimator::update(DataPackage& package)
+{
+  const DataPackage::_rtde_type_variant* value = nullptr;
+  {
+    // The position of the timestamp is only looked up once per recipe.
+    std::lock_guard<std::mutex> lk(mutex_);
+    if (package.getRecipe() != recipe_)
+    {
+      recipe_ = package.getRecipe();
+      has_timestamp_ = package.findField("timestamp", timestamp_index_);
+    }
+    if (has_timestamp_)
+    {
+      value = package.getDataAt(timestamp_index_);
+    }
+  }
+  if (value == nullptr || !std::holds_alternative<double>(*value))
+  {
+    return false;
+  }
+  const double timestamp = std::get<double>(*value);
+  const auto received = package.getKernelReceiveTime();
+  if (received == std::chrono::system_clock::time_point())
+  {
+    // No receive time available, e.g. because the socket doesn't support timestamping. The
+    // additional processing delay only makes the sample less likely to be a window minimum.
+    update(timestamp, std::chrono::steady_clock::now());
+    return true;
+  }
+  // The kernel receive time is taken from the system clock, so it is moved to the monotonic clock.
+  const auto age = std::chrono::system_clock::now() - received;
+  update(timestamp,
+         std::chrono::steady_clock::now() - std::chrono::duration_cast<std::chrono::steady_clock::duration>(age));
+  return true;
+}
+
+void ClockEstimator::update(const double robot_time, const std::chrono::steady_clock::time_point host_time)
+{
+  std::lock_guard<std::mutex> lk(mutex_);
+  if (!has_reference_)
+  {
+    host_reference_ = host_time;
+    has_reference_ = true;
+  }
+  else if (robot_time < last_robot_time_)
+  {
+    // The controller's timestamp went backwards, i.e. it has been restarted.
+    window_count_ = 0;
+    minima_.clear();
+    next_minimum_ = 0;
+    valid_ = false;
+  }
+  last_robot_time_ = robot_time;
+
+  const Sample sample{ robot_time, hostSeconds(host_time) - robot_time };
+  if (window_count_ == 0 || sample.offset < window_min_.offset)
+  {
+    window_min_ = sample;
+  }
+  if (++window_count_ < window_size_)
+  {
+    return;
+  }
+  window_count_ = 0;
+
+  if (minima_.size() < num_windows_)
+  {
+    minima_.push_back(window_min_);
+  }
+  else
+  {
+    minima_[next_minimum_] = window_min_;
+  }
+  next_minimum_ = (next_minimum_ + 1) % num_windows_;
+  fit();
+}
+
+void ClockEstimator::fit()
+{
+  if (minima_.size() < 2)
+  {
+    return;
+  }
+
+  // Least squares line through the window minima, relative to their mean for numerical stability
+  double mean_x = 0.0;
+  double mean_y = 0.0;
+  for (const auto& m : minima_)
+  {
+    mean_x += m.robot_time;
+    mean_y += m.offset;
+  }
+  mean_x /= minima_.size();
+  mean_y /= minima_.size();
+
+  double sxx = 0.0;
+  double sxy = 0.0;
+  for (const auto& m : minima_)
+  {
+    sxx += (m.robot_time - mean_x) * (m.robot_time - mean_x);
+    sxy += (m.robot_time - mean_x) * (m.offset - mean_y);
+  }
+  if (sxx <= 0.0)
+  {
+    return;
+  }
+
+  robot_reference_ = mean_x;
+  slope_ = sxy / sxx;
+  intercept_ = mean_y;
+
+  error_bound_ = 0.0;
+  for (const auto& m : minima_)
+  {
+    error_bound_ = std::max(error_bound_, std::abs(m.offset - (intercept_ + slope_ * (m.robot_time - mean_x))));
+  }
+  valid_ = true;
+}
+
+bool ClockEstimator::isValid() const
+{
+  std::lock_guard<std::mutex> lk(mutex_);
+  return valid_;
+}
+
+double ClockEstimator::getDrift() const
+{
+  std::lock_guard<std::mutex> lk(mutex_);
+  return slope_;
+}
+
+bool ClockEstimator::robotToHost(const double robot_time, std::chrono::steady_clock::time_point& host_time,
+                                 std::chrono::nanoseconds& error_bound) const
+{
+  std::lock_guard<std::mutex> lk(mutex_);
+  if (!valid_)
+  {
+    return false;
+  }
+  const double host_seconds = robot_time + intercept_ + slope_ * (robot_time - robot_reference_);
+  host_time = host_reference_ + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                    std::chrono::duration<double>(host_seconds));
+  error_bound = std::chrono::nanoseconds(static_cast<int64_t>(std::ceil(error_bound_ * 1e9)));
+  return true;
+}
+
+bool ClockEstimator::hostToRobot(const std::chrono::steady_clock::time_point host_time, double& robot_time,
+                                 double& error_bound) const
+{
+  std::lock_guard<std::mutex> lk(mutex_);
+  if (!valid_)
+  {
+    return false;
+  }
+  // host = robot + intercept + slope * (robot - reference), solved for robot
+  robot_time = (hostSeconds(host_time) - intercept_ + slope_ * robot_reference_) / (1.0 + slope_);
+  error_bound = error_bound_;
+  return true;
+}
+
+}  // namespace rtde_interface
+}  // namespace urcl
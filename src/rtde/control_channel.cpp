@@ -0,0 +1,113 @@
+// this is for emacs file handling -*- mode: c++; indent-tabs-mode: nil -*-
+
+// -- BEGIN LICENSE BLOCK ----------------------------------------------
+// Copyright 2026 Universal Robots A/S
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -- END LICENSE BLOCK ------------------------------------------------
+
+//----------------------------------------------------------------------
+/*!\file
+ *
+ * \date    2026-10-19
+ *
+ */
+//----------------------------------------------------------------------
+
+
+#include <algorithm>
+
+#include "ur_client_library/rtde/control_channel.h"
+#include "ur_client_library/log.h"
+
+namespace urcl
+{
+namespace rtde_interface
+{
+ControlChannel::Reply ControlChannel::expectReply(const PackageType type)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  Reply reply;
+  reply.type = type;
+  reply.id = next_id_++;
+  pending_[type].push_back({ reply.id, {} });
+  reply.future = pending_[type].back().promise.get_future();
+  return reply;
+}
+
+std::unique_ptr<RTDEPackage> ControlChannel::waitForReply(Reply& reply, const std::chrono::milliseconds timeout)
+{
+  if (!reply.valid() || reply.future.wait_for(timeout) != std::future_status::ready)
+  {
+    return nullptr;
+  }
+  try
+  {
+    return reply.future.get();
+  }
+  catch (const std::future_error&)
+  {
+    // The request has been canceled
+    return nullptr;
+  }
+}
+
+void ControlChannel::cancel(const Reply& reply)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = pending_.find(reply.type);
+  if (it == pending_.end())
+  {
+    return;
+  }
+  auto& requests = it->second;
+  requests.erase(std::remove_if(requests.begin(), requests.end(),
+                                [&reply](const PendingRequest& request) { return request.id == reply.id; }),
+                 requests.end());
+}
+
+void ControlChannel::clear()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  pending_.clear();
+}
+
+bool ControlChannel::route(std::unique_ptr<RTDEPackage>& package)
+{
+  switch (package->getType())
+  {
+    case PackageType::RTDE_DATA_PACKAGE:
+      return false;
+    case PackageType::RTDE_TEXT_MESSAGE:
+      URCL_LOG_INFO("Message from robot's RTDE interface: %s", package->toString().c_str());
+      return true;
+    default:
+      break;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = pending_.find(package->getType());
+  if (it == pending_.end() || it->second.empty())
+  {
+    URCL_LOG_WARN("Received RTDE control message without a pending request, discarding it: %s",
+                  package->toString().c_str());
+    return true;
+  }
+
+  it->second.front().promise.set_value(std::move(package));
+  it->second.pop_front();
+  return true;
+}
+
+}  // namespace rtde_interface
+}  // namespace urcl
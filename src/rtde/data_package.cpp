@@ -28,6 +28,7 @@
 
 #include "ur_client_library/rtde/data_package.h"
 
+#include <cctype>
 #include <functional>
 namespace urcl
 {
@@ -555,44 +556,116 @@ std::unordered_map<std::string, DataPackage::_rtde_type_variant> DataPackage::g_
   { "standard_analog_output_1", double() },
 };
 
+bool rtde_interface::DataPackage::getPackedBitRegister(const std::string& name, std::string& word, size_t& bit)
+{
+  static const std::string prefix = "output_bit_register_";
+  if (name.compare(0, prefix.size(), prefix) != 0 || name.size() == prefix.size() || name.size() > prefix.size() + 2)
+  {
+    return false;
+  }
+
+  size_t index = 0;
+  for (size_t i = prefix.size(); i < name.size(); ++i)
+  {
+    if (!std::isdigit(static_cast<unsigned char>(name[i])))
+    {
+      return false;
+    }
+    index = index * 10 + (name[i] - '0');
+  }
+  if (index >= 64)
+  {
+    return false;
+  }
+
+  word = index < 32 ? "output_bit_registers0_to_31" : "output_bit_registers32_to_63";
+  bit = index % 32;
+  return true;
+}
+
+bool rtde_interface::DataPackage::getPackedBit(const std::string& name, bool& val) const
+{
+  std::string word;
+  size_t bit;
+  size_t index;
+  if (!filled_ || !getPackedBitRegister(name, word, bit) || !findField(word, index))
+  {
+    return false;
+  }
+  val = (std::get<uint32_t>(data_[index]) >> bit) & 1;
+  return true;
+}
+
+rtde_interface::DataPackage::DataPackage(std::shared_ptr<const std::vector<std::string>> recipe)
+  : RTDEPackage(PackageType::RTDE_DATA_PACKAGE), recipe_id_(0), filled_(false), recipe_(std::move(recipe))
+{
+  // The types are resolved once, so parsing only has to fill in the values.
+  data_.reserve(recipe_->size());
+  known_.reserve(recipe_->size());
+  for (const auto& item : *recipe_)
+  {
+    auto it = g_type_list.find(item);
+    known_.push_back(it != g_type_list.end());
+    data_.push_back(it != g_type_list.end() ? it->second : _rtde_type_variant());
+  }
+}
+
+bool rtde_interface::DataPackage::findField(const std::string& name, size_t& index) const
+{
+  // Recipes are short, so a linear search is cheaper than hashing the name.
+  for (size_t i = 0; i < recipe_->size(); ++i)
+  {
+    if ((*recipe_)[i] == name)
+    {
+      index = i;
+      return known_[i];
+    }
+  }
+  return false;
+}
+
 void rtde_interface::DataPackage::initEmpty()
 {
-  for (auto& item : recipe_)
+  for (size_t i = 0; i < data_.size(); ++i)
   {
-    if (g_type_list.find(item) != g_type_list.end())
+    if (known_[i])
     {
-      _rtde_type_variant entry = g_type_list[item];
-      data_[item] = entry;
+      data_[i] = g_type_list[(*recipe_)[i]];
     }
   }
+  filled_ = true;
 }
 
 bool rtde_interface::DataPackage::parseWith(comm::BinParser& bp)
 {
   bp.parse(recipe_id_);
-  for (auto& item : recipe_)
+  for (size_t i = 0; i < data_.size(); ++i)
   {
-    if (g_type_list.find(item) != g_type_list.end())
-    {
-      _rtde_type_variant entry = g_type_list[item];
-      std::visit([&bp](auto&& arg) { bp.parse(arg); }, entry);
-      data_[item] = entry;
-    }
-    else
+    if (!known_[i])
     {
       return false;
     }
+    std::visit([&bp](auto&& arg) { bp.parse(arg); }, data_[i]);
   }
+  filled_ = true;
   return true;
 }
 
 std::string rtde_interface::DataPackage::toString() const
 {
   std::stringstream ss;
-  for (auto& item : data_)
+  if (!filled_)
   {
-    ss << item.first << ": ";
-    std::visit([&ss](auto&& arg) { ss << arg; }, item.second);
+    return ss.str();
+  }
+  for (size_t i = 0; i < data_.size(); ++i)
+  {
+    if (!known_[i])
+    {
+      continue;
+    }
+    ss << (*recipe_)[i] << ": ";
+    std::visit([&ss](auto&& arg) { ss << arg; }, data_[i]);
     ss << std::endl;
   }
   return ss.str();
@@ -602,18 +675,25 @@ size_t rtde_interface::DataPackage::serializePackage(uint8_t* buffer)
 {
   uint16_t payload_size = sizeof(recipe_id_);
 
-  for (auto& item : data_)
+  for (size_t i = 0; i < data_.size(); ++i)
   {
-    payload_size += std::visit([](auto&& arg) -> uint16_t { return sizeof(arg); }, item.second);
+    if (filled_ && known_[i])
+    {
+      payload_size += std::visit([](auto&& arg) -> uint16_t { return sizeof(arg); }, data_[i]);
+    }
   }
   size_t size = 0;
   size += PackageHeader::serializeHeader(buffer, PackageType::RTDE_DATA_PACKAGE, payload_size);
   size += comm::PackageSerializer::serialize(buffer + size, recipe_id_);
-  for (auto& item : recipe_)
+  for (size_t i = 0; i < data_.size(); ++i)
   {
+    if (!filled_ || !known_[i])
+    {
+      continue;
+    }
     size += std::visit(
         [&buffer, &size](auto&& arg) -> size_t { return comm::PackageSerializer::serialize(buffer + size, arg); },
-        data_[item]);
+        data_[i]);
   }
 
   return size;
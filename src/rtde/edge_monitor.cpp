@@ -0,0 +1,125 @@
+// this is for emacs file handling -*- mode: c++; indent-tabs-mode: nil -*-
+
+// -- BEGIN LICENSE BLOCK ----------------------------------------------
+// Copyright 2026 Universal Robots A/S
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -- END LICENSE BLOCK ------------------------------------------------
+
+//----------------------------------------------------------------------
+/*!\file
+ *
+ * \date    2026-10-19
+ *
+ */
+//----------------------------------------------------------------------
+
+
+#include "ur_client_library/rtde/edge_monitor.h"
+#include "ur_client_library/log.h"
+
+#include <type_traits>
+
+namespace urcl
+{
+namespace rtde_interface
+{
+bool EdgeMonitor::addCallback(const std::string& field, Callback callback)
+{
+  DataPackage::_rtde_type_variant value;
+  std::vector<std::string> recipe{ field };
+  DataPackage reference(recipe);
+  reference.initEmpty();
+  if (!reference.getData(field, value))
+  {
+    URCL_LOG_ERROR("Cannot register edge callback for unknown RTDE field '%s'", field.c_str());
+    return false;
+  }
+  if (!std::visit([](auto&& v) { return std::is_arithmetic<std::decay_t<decltype(v)>>::value; }, value))
+  {
+    URCL_LOG_ERROR("Edge callbacks are only supported for scalar RTDE fields, '%s' is not", field.c_str());
+    return false;
+  }
+
+  Watch watch{ field, callback, value, false, value.index(), "", 0, false, false, false, 0 };
+  if (!DataPackage::getPackedBitRegister(field, watch.word, watch.bit))
+  {
+    watch.word.clear();
+  }
+
+  std::lock_guard<std::mutex> lock(watches_mutex_);
+  watches_.push_back(std::move(watch));
+  return true;
+}
+
+void EdgeMonitor::resolve(Watch& watch, const DataPackage& package)
+{
+  watch.resolved = true;
+  watch.packed = false;
+  watch.present = package.findField(watch.field, watch.index);
+  if (!watch.present && !watch.word.empty())
+  {
+    watch.present = watch.packed = package.findField(watch.word, watch.index);
+  }
+}
+
+void EdgeMonitor::process(DataPackage& package)
+{
+  std::lock_guard<std::mutex> lock(watches_mutex_);
+  if (package.getRecipe() != recipe_)
+  {
+    recipe_ = package.getRecipe();
+    for (auto& watch : watches_)
+    {
+      watch.resolved = false;
+    }
+  }
+
+  DataPackage::_rtde_type_variant bit;
+  for (auto& watch : watches_)
+  {
+    if (!watch.resolved)
+    {
+      resolve(watch, package);
+    }
+    const DataPackage::_rtde_type_variant* value = watch.present ? package.getDataAt(watch.index) : nullptr;
+    if (value != nullptr && watch.packed)
+    {
+      if (!std::holds_alternative<uint32_t>(*value))
+      {
+        continue;
+      }
+      bit = static_cast<bool>((std::get<uint32_t>(*value) >> watch.bit) & 1);
+      value = &bit;
+    }
+    if (value == nullptr || value->index() != watch.type)
+    {
+      continue;
+    }
+    const DataPackage::_rtde_type_variant& current = *value;
+    if (watch.has_last && current != watch.last)
+    {
+      const auto start = std::chrono::steady_clock::now();
+      watch.callback(watch.last, current);
+      if (std::chrono::steady_clock::now() - start > budget_.load())
+      {
+        ++overruns_;
+      }
+    }
+    watch.last = current;
+    watch.has_last = true;
+  }
+}
+
+}  // namespace rtde_interface
+}  // namespace urcl
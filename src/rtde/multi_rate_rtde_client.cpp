@@ -0,0 +1,221 @@
+// this is for emacs file handling -*- mode: c++; indent-tabs-mode: nil -*-
+
+// -- BEGIN LICENSE BLOCK ----------------------------------------------
+// Copyright 2026 Universal Robots A/S
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -- END LICENSE BLOCK ------------------------------------------------
+
+//----------------------------------------------------------------------
+/*!\file
+ *
+ * \date    2026-10-19
+ *
+ */
+//----------------------------------------------------------------------
+
+
+#include "ur_client_library/rtde/multi_rate_rtde_client.h"
+#include "ur_client_library/exceptions.h"
+
+#include <future>
+
+namespace urcl
+{
+namespace rtde_interface
+{
+MultiRateRTDEClient::MultiRateRTDEClient(const std::string& robot_ip, comm::INotifier& notifier,
+                                         const std::vector<RTDEStreamConfig>& streams,
+                                         const std::vector<std::string>& input_recipe)
+  : running_(false)
+{
+  if (streams.empty())
+  {
+    throw UrException("MultiRateRTDEClient needs at least one output stream.");
+  }
+
+  for (size_t i = 0; i < streams.size(); ++i)
+  {
+    clients_.emplace_back(new RTDEClient(robot_ip, notifier, streams[i].output_recipe,
+                                         i == 0 ? input_recipe : std::vector<std::string>(), streams[i].frequency));
+  }
+  recipes_.resize(clients_.size());
+  fields_.resize(clients_.size());
+  update_counts_.resize(clients_.size(), 0);
+}
+
+MultiRateRTDEClient::~MultiRateRTDEClient()
+{
+  stopReaders();
+}
+
+bool MultiRateRTDEClient::init()
+{
+  if (running_)
+  {
+    return true;
+  }
+
+  std::vector<std::future<bool>> results;
+  for (auto& client : clients_)
+  {
+    results.push_back(std::async(std::launch::async, [&client]() { return client->init(); }));
+  }
+
+  bool success = true;
+  for (size_t i = 0; i < results.size(); ++i)
+  {
+    if (!results[i].get())
+    {
+      URCL_LOG_ERROR("Failed to initialize RTDE stream %zu", i);
+      success = false;
+      continue;
+    }
+    // The client appends the timestamp field, so the recipe is read back after initialization.
+    recipes_[i] = clients_[i]->getOutputRecipe();
+  }
+
+  std::lock_guard<std::mutex> lk(state_mutex_);
+  for (size_t i = 0; i < recipes_.size(); ++i)
+  {
+    fields_[i].clear();
+    for (const auto& name : recipes_[i])
+    {
+      fields_[i].push_back(&state_[name]);
+    }
+  }
+  return success;
+}
+
+bool MultiRateRTDEClient::start()
+{
+  if (running_)
+  {
+    return true;
+  }
+
+  for (size_t i = 0; i < clients_.size(); ++i)
+  {
+    if (!clients_[i]->start())
+    {
+      URCL_LOG_ERROR("Failed to start RTDE stream %zu, pausing the streams started before", i);
+      for (size_t j = 0; j < i; ++j)
+      {
+        clients_[j]->pause();
+      }
+      return false;
+    }
+  }
+
+  running_ = true;
+  for (size_t i = 0; i < clients_.size(); ++i)
+  {
+    readers_.emplace_back(&MultiRateRTDEClient::readStream, this, i);
+  }
+  return true;
+}
+
+bool MultiRateRTDEClient::pause()
+{
+  stopReaders();
+
+  bool success = true;
+  for (auto& client : clients_)
+  {
+    success &= client->pause();
+  }
+  return success;
+}
+
+bool MultiRateRTDEClient::getUpdateTime(const std::string& name, std::chrono::system_clock::time_point& updated) const
+{
+  std::lock_guard<std::mutex> lk(state_mutex_);
+  auto it = state_.find(name);
+  std::string word;
+  size_t bit;
+  if (it == state_.end() && DataPackage::getPackedBitRegister(name, word, bit))
+  {
+    it = state_.find(word);
+  }
+  if (it == state_.end() || !it->second.received)
+  {
+    return false;
+  }
+  updated = it->second.updated;
+  return true;
+}
+
+bool MultiRateRTDEClient::waitForUpdate(const size_t stream, const std::chrono::milliseconds timeout)
+{
+  std::unique_lock<std::mutex> lk(state_mutex_);
+  const uint64_t count = update_counts_.at(stream);
+  return update_cv_.wait_for(lk, timeout, [this, stream, count]() { return update_counts_[stream] != count; });
+}
+
+void MultiRateRTDEClient::readStream(const size_t stream)
+{
+  RTDEClient& client = *clients_[stream];
+  const std::vector<std::string>& recipe = recipes_[stream];
+  const std::vector<Field*>& fields = fields_[stream];
+  // Decoded outside of the lock into buffers reused for every package
+  std::vector<DataPackage::_rtde_type_variant> values(recipe.size());
+  std::vector<bool> decoded(recipe.size());
+
+  while (running_)
+  {
+    std::unique_ptr<DataPackage> package = client.getDataPackage(std::chrono::milliseconds(100));
+    if (!package)
+    {
+      continue;
+    }
+
+    for (size_t i = 0; i < recipe.size(); ++i)
+    {
+      decoded[i] = package->getData(recipe[i], values[i]);
+    }
+
+    const auto received = package->getKernelReceiveTime();
+    {
+      std::lock_guard<std::mutex> lk(state_mutex_);
+      for (size_t i = 0; i < fields.size(); ++i)
+      {
+        // Fields present in several recipes (e.g. timestamp) keep the newest value.
+        Field& field = *fields[i];
+        if (decoded[i] && (!field.received || received >= field.updated))
+        {
+          field.value = values[i];
+          field.updated = received;
+          field.received = true;
+        }
+      }
+      ++update_counts_[stream];
+    }
+    update_cv_.notify_all();
+  }
+}
+
+void MultiRateRTDEClient::stopReaders()
+{
+  running_ = false;
+  for (auto& reader : readers_)
+  {
+    if (reader.joinable())
+    {
+      reader.join();
+    }
+  }
+  readers_.clear();
+}
+
+}  // namespace rtde_interface
+}  // namespace urcl
@@ -0,0 +1,74 @@
+// this is for emacs file handling -*- mode: c++; indent-tabs-mode: nil -*-
+
+// -- BEGIN LICENSE BLOCK ----------------------------------------------
+// Copyright 2026 Universal Robots A/S
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -- END LICENSE BLOCK ------------------------------------------------
+
+//----------------------------------------------------------------------
+/*!\file
+ *
+ * \date    2026-10-19
+ *
+ */
+//----------------------------------------------------------------------
+
+
+
+#include "ur_client_library/rtde/negotiation_cache.h"
+
+#include <tuple>
+
+namespace urcl
+{
+namespace rtde_interface
+{
+bool NegotiationKey::operator<(const NegotiationKey& other) const
+{
+  return std::tie(host, port, output_recipe, input_recipe) <
+         std::tie(other.host, other.port, other.output_recipe, other.input_recipe);
+}
+
+void NegotiationCache::store(const NegotiationKey& key, const NegotiationResult& result)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  results_[key] = result;
+}
+
+bool NegotiationCache::lookup(const NegotiationKey& key, NegotiationResult& result) const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = results_.find(key);
+  if (it == results_.end())
+  {
+    return false;
+  }
+  result = it->second;
+  return true;
+}
+
+void NegotiationCache::erase(const NegotiationKey& key)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  results_.erase(key);
+}
+
+void NegotiationCache::clear()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  results_.clear();
+}
+
+}  // namespace rtde_interface
+}  // namespace urcl
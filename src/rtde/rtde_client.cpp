@@ -29,28 +29,102 @@
 #include "ur_client_library/rtde/rtde_client.h"
 #include "ur_client_library/exceptions.h"
 #include <algorithm>
+#include <map>
 
 namespace urcl
 {
 namespace rtde_interface
 {
+namespace
+{
+// Negotiation results per session, so that subsequent connections to the same robot can skip
+// the negotiation round trips.
+NegotiationCache negotiation_cache;
+
+// A packed word costs four bytes on the wire, an individual bit register one.
+const size_t MIN_PACKED_BIT_REGISTERS = 4;
+
+// Replaces individual output bit registers by the packed word containing them, if that doesn't
+// make the package larger. The individual bits remain accessible through DataPackage::getData().
+std::vector<std::string> packBitRegisters(const std::vector<std::string>& recipe)
+{
+  std::map<std::string, size_t> bits_per_word;
+  std::string word;
+  size_t bit;
+  for (const auto& name : recipe)
+  {
+    if (DataPackage::getPackedBitRegister(name, word, bit))
+    {
+      ++bits_per_word[word];
+    }
+    else if (name == "output_bit_registers0_to_31" || name == "output_bit_registers32_to_63")
+    {
+      // The word is transferred anyway
+      bits_per_word[name] = MIN_PACKED_BIT_REGISTERS;
+    }
+  }
+
+  std::vector<std::string> packed;
+  for (const auto& name : recipe)
+  {
+    const bool is_bit = DataPackage::getPackedBitRegister(name, word, bit);
+    const std::string& entry = is_bit ? word : name;
+    if (is_bit && bits_per_word[word] < MIN_PACKED_BIT_REGISTERS)
+    {
+      packed.push_back(name);
+    }
+    else if (std::find(packed.begin(), packed.end(), entry) == packed.end())
+    {
+      packed.push_back(entry);
+    }
+  }
+
+  if (packed.size() != recipe.size())
+  {
+    URCL_LOG_DEBUG("Packed output bit registers, output recipe shrunk from %zu to %zu entries", recipe.size(),
+                   packed.size());
+  }
+  return packed;
+}
+}  // namespace
+
 RTDEClient::RTDEClient(std::string robot_ip, comm::INotifier& notifier, const std::string& output_recipe_file,
                        const std::string& input_recipe_file, double target_frequency)
+  : RTDEClient(robot_ip, notifier, readRecipe(output_recipe_file), readRecipe(input_recipe_file), target_frequency)
+{
+}
+
+RTDEClient::RTDEClient(std::string robot_ip, comm::INotifier& notifier, const std::vector<std::string>& output_recipe,
+                       const std::vector<std::string>& input_recipe, double target_frequency)
   : stream_(robot_ip, UR_RTDE_PORT)
-  , output_recipe_(readRecipe(output_recipe_file))
-  , input_recipe_(readRecipe(input_recipe_file))
+  , output_recipe_(packBitRegisters(output_recipe))
+  , input_recipe_(input_recipe)
   , parser_(output_recipe_)
   , prod_(stream_, parser_)
+  , scheduler_(nullptr)
   , pipeline_(prod_, PIPELINE_NAME, notifier)
   , writer_(&stream_, input_recipe_)
   , max_frequency_(URE_MAX_FREQUENCY)
   , target_frequency_(target_frequency)
   , client_state_(ClientState::UNINITIALIZED)
+  , protocol_version_(1)
+  , restore_requested_(false)
+  , restoring_(false)
+  , fast_start_(true)
+  , init_retry_delay_(std::chrono::seconds(1))
 {
+  prod_.setStateCallback(std::bind(&RTDEClient::producerStateCallback, this, std::placeholders::_1));
+  pipeline_.setProductRouter(std::bind(&RTDEClient::routeProduct, this, std::placeholders::_1));
 }
 
 RTDEClient::~RTDEClient()
 {
+  // A running session restore still needs the pipeline, so it has to finish before disconnecting.
+  restore_requested_ = false;
+  if (restore_thread_.joinable())
+  {
+    restore_thread_.join();
+  }
   disconnect();
 }
 
@@ -61,15 +135,21 @@ bool RTDEClient::init()
     return true;
   }
 
-  static unsigned attempts = 0;
+  unsigned attempts = 0;
+  std::chrono::milliseconds retry_delay = init_retry_delay_;
   while (attempts < MAX_INITIALIZE_ATTEMPTS)
   {
     setupCommunication();
     if (client_state_ == ClientState::INITIALIZED)
+    {
+      // The robot doesn't send anything until the client is started.
+      prod_.suspendConnectionHealth();
       return true;
+    }
 
-    URCL_LOG_ERROR("Failed to initialize RTDE client, retrying in 10 seconds");
-    std::this_thread::sleep_for(std::chrono::seconds(10));
+    URCL_LOG_ERROR("Failed to initialize RTDE client, retrying in %ld ms", retry_delay.count());
+    std::this_thread::sleep_for(retry_delay);
+    retry_delay = std::min(retry_delay * 2, std::max(MAX_INIT_RETRY_DELAY, init_retry_delay_));
     attempts++;
   }
   std::stringstream ss;
@@ -84,162 +164,168 @@ void RTDEClient::setupCommunication()
   pipeline_.init();
   pipeline_.run();
 
-  uint16_t protocol_version = MAX_RTDE_PROTOCOL_VERSION;
-  while (!negotiateProtocolVersion(protocol_version) && client_state_ == ClientState::INITIALIZING)
+  const bool fast_setup = fast_start_ && setupFromCache();
+  if (client_state_ == ClientState::UNINITIALIZED)
+    return;
+
+  if (!fast_setup)
   {
-    URCL_LOG_INFO("Robot did not accept RTDE protocol version '%hu'. Trying lower protocol version", protocol_version);
-    protocol_version--;
-    if (protocol_version == 0)
+    uint16_t protocol_version = MAX_RTDE_PROTOCOL_VERSION;
+    while (!negotiateProtocolVersion(protocol_version) && client_state_ == ClientState::INITIALIZING)
     {
-      throw UrException("Protocol version for RTDE communication could not be established. Robot didn't accept any of "
-                        "the suggested versions.");
+      URCL_LOG_INFO("Robot did not accept RTDE protocol version '%hu'. Trying lower protocol version",
+                    protocol_version);
+      protocol_version--;
+      if (protocol_version == 0)
+      {
+        throw UrException("Protocol version for RTDE communication could not be established. Robot didn't accept any "
+                          "of the suggested versions.");
+      }
     }
-  }
-  if (client_state_ == ClientState::UNINITIALIZED)
-    return;
+    if (client_state_ == ClientState::UNINITIALIZED)
+      return;
 
-  URCL_LOG_INFO("Negotiated RTDE protocol version to %hu.", protocol_version);
-  parser_.setProtocolVersion(protocol_version);
+    URCL_LOG_INFO("Negotiated RTDE protocol version to %hu.", protocol_version);
+    parser_.setProtocolVersion(protocol_version);
+    protocol_version_ = protocol_version;
 
-  queryURControlVersion();
-  if (client_state_ == ClientState::UNINITIALIZED)
-    return;
+    queryURControlVersion();
+    if (client_state_ == ClientState::UNINITIALIZED)
+      return;
 
-  if (urcontrol_version_.major < 5)
-  {
-    max_frequency_ = CB3_MAX_FREQUENCY;
-  }
+    checkTargetFrequency();
 
-  if (target_frequency_ == 0)
-  {
-    // Default to maximum frequency
-    target_frequency_ = max_frequency_;
-  }
-  else if (target_frequency_ <= 0.0 || target_frequency_ > max_frequency_)
-  {
-    // Target frequency outside valid range
-    throw UrException("Invalid target frequency of RTDE connection");
+    setupOutputs(protocol_version);
+    if (client_state_ == ClientState::UNINITIALIZED)
+      return;
   }
 
-  setupOutputs(protocol_version);
-  if (client_state_ == ClientState::UNINITIALIZED)
-    return;
-
-  if (!isRobotBooted())
+  // Cached results are only stored once the robot has been found booted, so the probe is only
+  // needed for a full handshake.
+  if (!fast_setup && !isRobotBooted())
   {
     disconnect();
     return;
   }
 
-  setupInputs();
-  if (client_state_ == ClientState::UNINITIALIZED)
-    return;
+  if (!fast_setup)
+  {
+    if (!input_recipe_.empty())
+    {
+      setupInputs();
+      if (client_state_ == ClientState::UNINITIALIZED)
+        return;
+    }
+
+    negotiation_cache.store(getNegotiationKey(), { protocol_version_, urcontrol_version_ });
+  }
 
   // We finished communication for now
   pipeline_.stop();
   client_state_ = ClientState::INITIALIZED;
 }
 
-bool RTDEClient::negotiateProtocolVersion(const uint16_t protocol_version)
+bool RTDEClient::setupFromCache()
 {
-  // Protocol version should always be 1 before starting negotiation
+  NegotiationResult cached;
+  if (!negotiation_cache.lookup(getNegotiationKey(), cached))
+  {
+    return false;
+  }
+
+  urcontrol_version_ = cached.urcontrol_version;
+  checkTargetFrequency();
+
+  // Send all requests at once, the robot answers them in order.
   parser_.setProtocolVersion(1);
-  static unsigned num_retries = 0;
-  uint8_t buffer[4096];
-  size_t size;
-  size_t written;
-  size = RequestProtocolVersionRequest::generateSerializedRequest(buffer, protocol_version);
-  if (!stream_.write(buffer, size, written))
+  auto version_reply = sendProtocolVersionRequest(cached.protocol_version);
+  auto output_reply = sendOutputSetup(cached.protocol_version);
+  ControlChannel::Reply input_reply;
+  if (!input_recipe_.empty())
   {
-    URCL_LOG_ERROR("Sending protocol version query to robot failed, disconnecting");
-    disconnect();
+    input_reply = sendInputSetup();
+  }
+
+  std::unique_ptr<RTDEPackage> version = awaitReply(version_reply);
+  if (version == nullptr || !static_cast<RequestProtocolVersion*>(version.get())->accepted_)
+  {
+    URCL_LOG_WARN("Robot did not confirm the RTDE protocol version used before. Performing a full handshake.");
+    negotiation_cache.erase(getNegotiationKey());
+    control_channel_.clear();
     return false;
   }
+  parser_.setProtocolVersion(cached.protocol_version);
+  protocol_version_ = cached.protocol_version;
+  URCL_LOG_INFO("Reusing RTDE protocol version %hu.", protocol_version_);
 
-  while (num_retries < MAX_REQUEST_RETRIES)
+  if (handleOutputSetupReply(awaitReply(output_reply)) && !input_recipe_.empty())
   {
-    std::unique_ptr<RTDEPackage> package;
-    if (!pipeline_.getLatestProduct(package, std::chrono::milliseconds(1000)))
-    {
-      URCL_LOG_ERROR("failed to get package from rtde interface, disconnecting");
-      disconnect();
-      return false;
-    }
-    if (rtde_interface::RequestProtocolVersion* tmp_version =
-            dynamic_cast<rtde_interface::RequestProtocolVersion*>(package.get()))
-    {
-      // Reset the num_tries variable in case we have to try with another protocol version.
-      num_retries = 0;
-      return tmp_version->accepted_;
-    }
-    else
-    {
-      std::stringstream ss;
-      ss << "Did not receive protocol negotiation answer from robot. Message received instead: " << std::endl
-         << package->toString() << ". Retrying...";
-      num_retries++;
-      URCL_LOG_WARN("%s", ss.str().c_str());
-    }
+    handleInputSetupReply(awaitReply(input_reply));
   }
-  std::stringstream ss;
-  ss << "Could not negotiate RTDE protocol version after " << MAX_REQUEST_RETRIES
-     << " tries. Please check the output of the "
-        "negotiation attempts above to get a hint what could be wrong.";
-  throw UrException(ss.str());
+  return true;
 }
 
-void RTDEClient::queryURControlVersion()
+NegotiationKey RTDEClient::getNegotiationKey()
 {
-  static unsigned num_retries = 0;
-  uint8_t buffer[4096];
-  size_t size;
+  return { stream_.getHost(), stream_.getPort(), output_recipe_, input_recipe_ };
+}
+
+void RTDEClient::checkTargetFrequency()
+{
+  if (urcontrol_version_.major < 5)
+  {
+    max_frequency_ = CB3_MAX_FREQUENCY;
+  }
+
+  if (target_frequency_ == 0)
+  {
+    // Default to maximum frequency
+    target_frequency_ = max_frequency_;
+  }
+  else if (target_frequency_ <= 0.0 || target_frequency_ > max_frequency_)
+  {
+    // Target frequency outside valid range
+    throw UrException("Invalid target frequency of RTDE connection");
+  }
+}
+
+ControlChannel::Reply RTDEClient::sendRequest(const uint8_t* buffer, const size_t size, const PackageType reply_type)
+{
+  auto reply = control_channel_.expectReply(reply_type);
   size_t written;
-  size = GetUrcontrolVersionRequest::generateSerializedRequest(buffer);
   if (!stream_.write(buffer, size, written))
   {
-    URCL_LOG_ERROR("Sending urcontrol version query request to robot failed, disconnecting");
-    disconnect();
-    return;
+    control_channel_.cancel(reply);
+    return ControlChannel::Reply();
   }
+  return reply;
+}
 
-  std::unique_ptr<RTDEPackage> package;
-  while (num_retries < MAX_REQUEST_RETRIES)
+std::unique_ptr<RTDEPackage> RTDEClient::awaitReply(ControlChannel::Reply& reply)
+{
+  if (!reply.valid())
   {
-    if (!pipeline_.getLatestProduct(package, std::chrono::milliseconds(1000)))
-    {
-      URCL_LOG_ERROR("No answer to urcontrol version query was received from robot, disconnecting");
-      disconnect();
-      return;
-    }
+    return nullptr;
+  }
+  return ControlChannel::waitForReply(reply, REQUEST_TIMEOUT);
+}
 
-    if (rtde_interface::GetUrcontrolVersion* tmp_urcontrol_version =
-            dynamic_cast<rtde_interface::GetUrcontrolVersion*>(package.get()))
-    {
-      urcontrol_version_ = tmp_urcontrol_version->version_information_;
-      return;
-    }
-    else
-    {
-      std::stringstream ss;
-      ss << "Did not receive protocol negotiation answer from robot. Message received instead: " << std::endl
-         << package->toString() << ". Retrying...";
-      num_retries++;
-      URCL_LOG_WARN("%s", ss.str().c_str());
-    }
+ControlChannel::Reply RTDEClient::sendProtocolVersionRequest(const uint16_t protocol_version)
+{
+  uint8_t buffer[4096];
+  size_t size = RequestProtocolVersionRequest::generateSerializedRequest(buffer, protocol_version);
+  auto reply = sendRequest(buffer, size, PackageType::RTDE_REQUEST_PROTOCOL_VERSION);
+  if (!reply.valid())
+  {
+    URCL_LOG_ERROR("Sending protocol version query to robot failed");
   }
-  std::stringstream ss;
-  ss << "Could not query urcontrol version after " << MAX_REQUEST_RETRIES
-     << " tries. Please check the output of the "
-        "negotiation attempts above to get a hint what could be wrong.";
-  throw UrException(ss.str());
+  return reply;
 }
 
-void RTDEClient::setupOutputs(const uint16_t protocol_version)
+ControlChannel::Reply RTDEClient::sendOutputSetup(const uint16_t protocol_version)
 {
-  static unsigned num_retries = 0;
-  size_t size;
-  size_t written;
   uint8_t buffer[4096];
+  size_t size;
   URCL_LOG_INFO("Setting up RTDE communication with frequency %f", target_frequency_);
   // Add timestamp to rtde output recipe, used to check if robot is booted
   const std::string timestamp = "timestamp";
@@ -257,123 +343,126 @@ void RTDEClient::setupOutputs(const uint16_t protocol_version)
     size = ControlPackageSetupOutputsRequest::generateSerializedRequest(buffer, output_recipe_);
   }
 
-  // Send output recipe to robot
-  if (!stream_.write(buffer, size, written))
+  auto reply = sendRequest(buffer, size, PackageType::RTDE_CONTROL_PACKAGE_SETUP_OUTPUTS);
+  if (!reply.valid())
   {
-    URCL_LOG_ERROR("Could not send RTDE output recipe to robot, disconnecting");
-    disconnect();
-    return;
+    URCL_LOG_ERROR("Could not send RTDE output recipe to robot");
   }
+  return reply;
+}
 
-  while (num_retries < MAX_REQUEST_RETRIES)
+ControlChannel::Reply RTDEClient::sendInputSetup()
+{
+  uint8_t buffer[4096];
+  size_t size = ControlPackageSetupInputsRequest::generateSerializedRequest(buffer, input_recipe_);
+  auto reply = sendRequest(buffer, size, PackageType::RTDE_CONTROL_PACKAGE_SETUP_INPUTS);
+  if (!reply.valid())
   {
-    std::unique_ptr<RTDEPackage> package;
-    if (!pipeline_.getLatestProduct(package, std::chrono::milliseconds(1000)))
-    {
-      URCL_LOG_ERROR("Did not receive confirmation on RTDE output recipe, disconnecting");
-      disconnect();
-      return;
-    }
-
-    if (rtde_interface::ControlPackageSetupOutputs* tmp_output =
-            dynamic_cast<rtde_interface::ControlPackageSetupOutputs*>(package.get()))
+    URCL_LOG_ERROR("Could not send RTDE input recipe to robot");
+  }
+  return reply;
+}
 
-    {
-      std::vector<std::string> variable_types = splitVariableTypes(tmp_output->variable_types_);
-      assert(output_recipe_.size() == variable_types.size());
-      for (std::size_t i = 0; i < variable_types.size(); ++i)
-      {
-        URCL_LOG_DEBUG("%s confirmed as datatype: %s", output_recipe_[i].c_str(), variable_types[i].c_str());
-        if (variable_types[i] == "NOT_FOUND")
-        {
-          std::string message = "Variable '" + output_recipe_[i] +
-                                "' not recognized by the robot. Probably your output recipe contains errors";
-          throw UrException(message);
-        }
-      }
-      return;
-    }
-    else
-    {
-      std::stringstream ss;
-      ss << "Did not receive answer to RTDE output setup. Message received instead: " << std::endl
-         << package->toString() << ". Retrying...";
-      num_retries++;
-      URCL_LOG_WARN("%s", ss.str().c_str());
-    }
+bool RTDEClient::negotiateProtocolVersion(const uint16_t protocol_version)
+{
+  // Protocol version should always be 1 before starting negotiation
+  parser_.setProtocolVersion(1);
+  auto reply = sendProtocolVersionRequest(protocol_version);
+  std::unique_ptr<RTDEPackage> package = awaitReply(reply);
+  if (package == nullptr)
+  {
+    URCL_LOG_ERROR("No answer to protocol version query was received from robot, disconnecting");
+    disconnect();
+    return false;
   }
-  std::stringstream ss;
-  ss << "Could not setup RTDE outputs after " << MAX_REQUEST_RETRIES
-     << " tries. Please check the output of the "
-        "negotiation attempts above to get a hint what could be wrong.";
-  throw UrException(ss.str());
+  return static_cast<RequestProtocolVersion*>(package.get())->accepted_;
 }
 
-void RTDEClient::setupInputs()
+void RTDEClient::queryURControlVersion()
 {
-  static unsigned num_retries = 0;
-  size_t size;
-  size_t written;
   uint8_t buffer[4096];
-  size = ControlPackageSetupInputsRequest::generateSerializedRequest(buffer, input_recipe_);
-  if (!stream_.write(buffer, size, written))
+  size_t size = GetUrcontrolVersionRequest::generateSerializedRequest(buffer);
+  auto reply = sendRequest(buffer, size, PackageType::RTDE_GET_URCONTROL_VERSION);
+  std::unique_ptr<RTDEPackage> package = awaitReply(reply);
+  if (package == nullptr)
   {
-    URCL_LOG_ERROR("Could not send RTDE input recipe to robot, disconnecting");
+    URCL_LOG_ERROR("No answer to urcontrol version query was received from robot, disconnecting");
     disconnect();
     return;
   }
+  urcontrol_version_ = static_cast<GetUrcontrolVersion*>(package.get())->version_information_;
+}
+
+void RTDEClient::setupOutputs(const uint16_t protocol_version)
+{
+  auto reply = sendOutputSetup(protocol_version);
+  handleOutputSetupReply(awaitReply(reply));
+}
+
+bool RTDEClient::handleOutputSetupReply(std::unique_ptr<RTDEPackage> package)
+{
+  if (package == nullptr)
+  {
+    URCL_LOG_ERROR("Did not receive confirmation on RTDE output recipe, disconnecting");
+    disconnect();
+    return false;
+  }
 
-  while (num_retries < MAX_REQUEST_RETRIES)
+  ControlPackageSetupOutputs* tmp_output = static_cast<ControlPackageSetupOutputs*>(package.get());
+  std::vector<std::string> variable_types = splitVariableTypes(tmp_output->variable_types_);
+  assert(output_recipe_.size() == variable_types.size());
+  for (std::size_t i = 0; i < variable_types.size(); ++i)
   {
-    std::unique_ptr<RTDEPackage> package;
-    if (!pipeline_.getLatestProduct(package, std::chrono::milliseconds(1000)))
+    URCL_LOG_DEBUG("%s confirmed as datatype: %s", output_recipe_[i].c_str(), variable_types[i].c_str());
+    if (variable_types[i] == "NOT_FOUND")
     {
-      URCL_LOG_ERROR("Did not receive confirmation on RTDE input recipe, disconnecting");
-      disconnect();
-      return;
+      std::string message = "Variable '" + output_recipe_[i] +
+                            "' not recognized by the robot. Probably your output recipe contains errors";
+      throw UrException(message);
     }
+  }
+  // The recipe might have been extended by the timestamp.
+  parser_.setRecipe(output_recipe_);
+  return true;
+}
 
-    if (rtde_interface::ControlPackageSetupInputs* tmp_input =
-            dynamic_cast<rtde_interface::ControlPackageSetupInputs*>(package.get()))
+void RTDEClient::setupInputs()
+{
+  auto reply = sendInputSetup();
+  handleInputSetupReply(awaitReply(reply));
+}
 
-    {
-      std::vector<std::string> variable_types = splitVariableTypes(tmp_input->variable_types_);
-      assert(input_recipe_.size() == variable_types.size());
-      for (std::size_t i = 0; i < variable_types.size(); ++i)
-      {
-        URCL_LOG_DEBUG("%s confirmed as datatype: %s", input_recipe_[i].c_str(), variable_types[i].c_str());
-        if (variable_types[i] == "NOT_FOUND")
-        {
-          std::string message = "Variable '" + input_recipe_[i] +
-                                "' not recognized by the robot. Probably your input recipe contains errors";
-          throw UrException(message);
-        }
-        else if (variable_types[i] == "IN_USE")
-        {
-          std::string message = "Variable '" + input_recipe_[i] +
-                                "' is currently controlled by another RTDE client. The input recipe can't be used as "
-                                "configured";
-          throw UrException(message);
-        }
-      }
-      writer_.init(tmp_input->input_recipe_id_);
+bool RTDEClient::handleInputSetupReply(std::unique_ptr<RTDEPackage> package)
+{
+  if (package == nullptr)
+  {
+    URCL_LOG_ERROR("Did not receive confirmation on RTDE input recipe, disconnecting");
+    disconnect();
+    return false;
+  }
 
-      return;
+  ControlPackageSetupInputs* tmp_input = static_cast<ControlPackageSetupInputs*>(package.get());
+  std::vector<std::string> variable_types = splitVariableTypes(tmp_input->variable_types_);
+  assert(input_recipe_.size() == variable_types.size());
+  for (std::size_t i = 0; i < variable_types.size(); ++i)
+  {
+    URCL_LOG_DEBUG("%s confirmed as datatype: %s", input_recipe_[i].c_str(), variable_types[i].c_str());
+    if (variable_types[i] == "NOT_FOUND")
+    {
+      std::string message =
+          "Variable '" + input_recipe_[i] + "' not recognized by the robot. Probably your input recipe contains errors";
+      throw UrException(message);
     }
-    else
+    else if (variable_types[i] == "IN_USE")
     {
-      std::stringstream ss;
-      ss << "Did not receive answer to RTDE input setup. Message received instead: " << std::endl
-         << package->toString() << ". Retrying...";
-      num_retries++;
-      URCL_LOG_WARN("%s", ss.str().c_str());
+      std::string message = "Variable '" + input_recipe_[i] +
+                            "' is currently controlled by another RTDE client. The input recipe can't be used as "
+                            "configured";
+      throw UrException(message);
     }
   }
-  std::stringstream ss;
-  ss << "Could not setup RTDE inputs after " << MAX_REQUEST_RETRIES
-     << " tries. Please check the output of the "
-        "negotiation attempts above to get a hint what could be wrong.";
-  throw UrException(ss.str());
+  writer_.init(tmp_input->input_recipe_id_);
+  return true;
 }
 
 void RTDEClient::disconnect()
@@ -382,9 +471,134 @@ void RTDEClient::disconnect()
   sendPause();
   pipeline_.stop();
   stream_.disconnect();
+  control_channel_.clear();
   client_state_ = ClientState::UNINITIALIZED;
 }
 
+bool RTDEClient::addEdgeCallback(const std::string& field, EdgeMonitor::Callback callback)
+{
+  // Individual bit registers might have been replaced by the word containing them
+  std::string word;
+  size_t bit;
+  const bool in_recipe =
+      std::find(output_recipe_.begin(), output_recipe_.end(), field) != output_recipe_.end() ||
+      (DataPackage::getPackedBitRegister(field, word, bit) &&
+       std::find(output_recipe_.begin(), output_recipe_.end(), word) != output_recipe_.end());
+  if (!in_recipe)
+  {
+    URCL_LOG_ERROR("Cannot register edge callback for '%s', it is not part of the output recipe", field.c_str());
+    return false;
+  }
+  return edge_monitor_.addCallback(field, callback);
+}
+
+bool RTDEClient::routeProduct(std::unique_ptr<RTDEPackage>& package)
+{
+  if (package->getType() == PackageType::RTDE_DATA_PACKAGE)
+  {
+    DataPackage& data_package = static_cast<DataPackage&>(*package);
+    edge_monitor_.process(data_package);
+    clock_estimator_.update(data_package);
+    if (control::PhaseLockedScheduler* scheduler = scheduler_)
+    {
+      scheduler->onPackage(package->getKernelReceiveTime());
+    }
+  }
+  return control_channel_.route(package);
+}
+
+void RTDEClient::producerStateCallback(const comm::ProducerState state)
+{
+  // The phase of the previous connection is meaningless for the next one
+  control::PhaseLockedScheduler* scheduler = scheduler_;
+  if (scheduler && state != comm::ProducerState::CONNECTED)
+  {
+    scheduler->reset();
+  }
+
+  // The initial connection is set up by init(), only connections established afterwards need a
+  // restore of the session.
+  if (state == comm::ProducerState::CONNECTED && client_state_ > ClientState::INITIALIZING)
+  {
+    restore_requested_ = true;
+    // The handshake needs the producer thread, so it has to run in a separate thread.
+    if (!restoring_.exchange(true))
+    {
+      if (restore_thread_.joinable())
+      {
+        restore_thread_.join();
+      }
+      restore_thread_ = std::thread(&RTDEClient::runSessionRestore, this);
+    }
+  }
+
+  if (connection_state_callback_)
+  {
+    connection_state_callback_(state);
+  }
+}
+
+void RTDEClient::runSessionRestore()
+{
+  do
+  {
+    while (restore_requested_.exchange(false))
+    {
+      if (restoreSession())
+      {
+        URCL_LOG_INFO("RTDE session restored after reconnecting to the robot");
+      }
+      else
+      {
+        URCL_LOG_ERROR("Failed to restore the RTDE session after reconnecting. Please initialize the client again.");
+      }
+    }
+    restoring_ = false;
+    // A reconnect might have happened right before resetting the flag
+  } while (restore_requested_ && !restoring_.exchange(true));
+}
+
+bool RTDEClient::restoreSession()
+{
+  const bool was_running = client_state_ == ClientState::RUNNING;
+  try
+  {
+    if (!negotiateProtocolVersion(protocol_version_))
+    {
+      if (client_state_ != ClientState::UNINITIALIZED)
+      {
+        disconnect();
+      }
+      return false;
+    }
+    parser_.setProtocolVersion(protocol_version_);
+
+    setupOutputs(protocol_version_);
+    if (client_state_ == ClientState::UNINITIALIZED)
+      return false;
+
+    if (!input_recipe_.empty())
+    {
+      setupInputs();
+      if (client_state_ == ClientState::UNINITIALIZED)
+        return false;
+    }
+
+    if (was_running)
+    {
+      return sendStart();
+    }
+    prod_.suspendConnectionHealth();
+    return true;
+  }
+  catch (const UrException& e)
+  {
+    URCL_LOG_ERROR("%s", e.what());
+    disconnect();
+    return false;
+  }
+}
+
 bool RTDEClient::isRobotBooted()
 {
   // We need  to trigger the robot to start sending RTDE data packages in the negotiated format, in order to read
@@ -458,6 +672,7 @@ bool RTDEClient::pause()
 
   if (sendPause())
   {
+    prod_.suspendConnectionHealth();
     client_state_ = ClientState::PAUSED;
     return true;
   }
@@ -467,46 +682,105 @@ bool RTDEClient::pause()
   }
 }
 
+bool RTDEClient::reconfigure(const std::vector<std::string>& output_recipe, const double target_frequency)
+{
+  if (client_state_ < ClientState::INITIALIZED)
+  {
+    URCL_LOG_ERROR("Cannot reconfigure an uninitialized client, please initialize it first");
+    return false;
+  }
+  const double frequency = target_frequency == 0.0 ? max_frequency_ : target_frequency;
+  if (frequency <= 0.0 || frequency > max_frequency_)
+  {
+    URCL_LOG_ERROR("Invalid target frequency of RTDE connection: %f", target_frequency);
+    return false;
+  }
+  if (protocol_version_ < 2 && frequency != target_frequency_)
+  {
+    URCL_LOG_ERROR("The RTDE frequency can't be changed with protocol version %hu", protocol_version_);
+    return false;
+  }
+
+  const bool was_running = client_state_ == ClientState::RUNNING;
+  if (was_running && !pause())
+  {
+    return false;
+  }
+  // Replies are received through the pipeline, which is stopped again afterwards if it has only
+  // been started for that.
+  const bool pipeline_was_running = pipeline_.isRunning();
+  pipeline_.run();
+
+  const std::vector<std::string> previous_recipe = output_recipe_;
+  const double previous_frequency = target_frequency_;
+  output_recipe_ = packBitRegisters(output_recipe);
+  target_frequency_ = frequency;
+
+  bool success = false;
+  try
+  {
+    auto reply = sendOutputSetup(protocol_version_);
+    success = handleOutputSetupReply(awaitReply(reply));
+  }
+  catch (const UrException& e)
+  {
+    URCL_LOG_ERROR("%s", e.what());
+  }
+  if (client_state_ == ClientState::UNINITIALIZED)
+  {
+    return false;
+  }
+
+  if (!success)
+  {
+    URCL_LOG_WARN("Reconfiguring RTDE outputs failed, restoring the previous configuration");
+    output_recipe_ = previous_recipe;
+    target_frequency_ = previous_frequency;
+    setupOutputs(protocol_version_);
+    if (client_state_ == ClientState::UNINITIALIZED)
+    {
+      return false;
+    }
+  }
+
+  if (!pipeline_was_running)
+  {
+    pipeline_.stop();
+  }
+  if (was_running && !start())
+  {
+    return false;
+  }
+  return success;
+}
+
 bool RTDEClient::sendStart()
 {
   uint8_t buffer[4096];
   size_t size;
   size_t written;
   size = ControlPackageStartRequest::generateSerializedRequest(buffer);
+  auto reply = control_channel_.expectReply(PackageType::RTDE_CONTROL_PACKAGE_START);
   if (!stream_.write(buffer, size, written))
   {
     URCL_LOG_ERROR("Sending RTDE start command failed!");
+    control_channel_.cancel(reply);
     return false;
   }
 
-  std::unique_ptr<RTDEPackage> package;
-  static unsigned num_retries = 0;
-  while (num_retries < MAX_REQUEST_RETRIES)
+  std::unique_ptr<RTDEPackage> package = ControlChannel::waitForReply(reply, REQUEST_TIMEOUT);
+  if (package == nullptr)
   {
-    if (!pipeline_.getLatestProduct(package, std::chrono::milliseconds(1000)))
-    {
-      URCL_LOG_ERROR("Could not get response to RTDE communication start request from robot");
-      return false;
-    }
-
-    if (rtde_interface::ControlPackageStart* tmp = dynamic_cast<rtde_interface::ControlPackageStart*>(package.get()))
-    {
-      return tmp->accepted_;
-    }
-    else
-    {
-      std::stringstream ss;
-      ss << "Did not receive answer to RTDE start request. Message received instead: " << std::endl
-         << package->toString();
-      URCL_LOG_WARN("%s", ss.str().c_str());
-      return false;
-    }
+    URCL_LOG_ERROR("Could not get response to RTDE communication start request from robot");
+    return false;
   }
-  std::stringstream ss;
-  ss << "Could not start RTDE communication after " << MAX_REQUEST_RETRIES
-     << " tries. Please check the output of the "
-        "negotiation attempts above to get a hint what could be wrong.";
-  throw UrException(ss.str());
+  if (!static_cast<ControlPackageStart*>(package.get())->accepted_)
+  {
+    return false;
+  }
+  // The robot streams data from now on, so silence means a lost link.
+  prod_.resumeConnectionHealth();
+  return true;
 }
 
 bool RTDEClient::sendPause()
@@ -515,41 +789,22 @@ bool RTDEClient::sendPause()
   size_t size;
   size_t written;
   size = ControlPackagePauseRequest::generateSerializedRequest(buffer);
+  auto reply = control_channel_.expectReply(PackageType::RTDE_CONTROL_PACKAGE_PAUSE);
   if (!stream_.write(buffer, size, written))
   {
     URCL_LOG_ERROR("Sending RTDE pause command failed!");
+    control_channel_.cancel(reply);
     return false;
   }
-  static unsigned num_retries = 0;
-  while (num_retries < MAX_REQUEST_RETRIES)
-  {
-    std::unique_ptr<RTDEPackage> package;
 
-    if (!pipeline_.getLatestProduct(package, std::chrono::milliseconds(1000)))
-    {
-      URCL_LOG_ERROR("Could not get response to RTDE communication pause request from robot");
-      return false;
-    }
-
-    if (rtde_interface::ControlPackagePause* tmp = dynamic_cast<rtde_interface::ControlPackagePause*>(package.get()))
-    {
-      client_state_ = ClientState::PAUSED;
-      return tmp->accepted_;
-    }
-    else
-    {
-      std::stringstream ss;
-      ss << "Did not receive answer to RTDE pause request. Message received instead: " << std::endl
-         << package->toString();
-      URCL_LOG_WARN("%s", ss.str().c_str());
-      num_retries++;
-    }
+  std::unique_ptr<RTDEPackage> package = ControlChannel::waitForReply(reply, REQUEST_TIMEOUT);
+  if (package == nullptr)
+  {
+    URCL_LOG_ERROR("Could not get response to RTDE communication pause request from robot");
+    return false;
   }
-  std::stringstream ss;
-  ss << "Could not pause RTDE communication after " << MAX_REQUEST_RETRIES
-     << " tries. Please check the output of the "
-        "negotiation attempts above to get a hint what could be wrong.";
-  throw UrException(ss.str());
+  client_state_ = ClientState::PAUSED;
+  return static_cast<ControlPackagePause*>(package.get())->accepted_;
 }
 
 std::vector<std::string> RTDEClient::readRecipe(const std::string& recipe_file)
@@ -591,6 +846,12 @@ std::string RTDEClient::getIP() const
   return stream_.getIP();
 }
 
+void RTDEClient::setBusyPolling(const comm::BusyPollConfig& config, const int producer_cpu)
+{
+  stream_.setBusyPolling(config);
+  pipeline_.setProducerCPUAffinity(producer_cpu);
+}
+
 RTDEWriter& RTDEClient::getWriter()
 {
   return writer_;
@@ -40,6 +40,11 @@ RTDEWriter::RTDEWriter(comm::URStream<RTDEPackage>* stream, const std::vector<st
 void RTDEWriter::init(uint8_t recipe_id)
 {
   recipe_id_ = recipe_id;
+  if (running_)
+  {
+    // Already running, e.g. when the recipe is set up again after a reconnect.
+    return;
+  }
   package_.initEmpty();
   running_ = true;
   writer_thread_ = std::thread(&RTDEWriter::run, this);
@@ -31,7 +31,7 @@
 namespace urcl
 {
 CalibrationChecker::CalibrationChecker(const std::string& expected_hash)
-  : expected_hash_(expected_hash), checked_(false), matches_(false)
+  : expected_hash_(expected_hash), checked_(false), matches_(false), cancelled_(false)
 {
 }
 bool CalibrationChecker::consume(std::shared_ptr<primary_interface::PrimaryPackage> product)
@@ -41,11 +41,27 @@ bool CalibrationChecker::consume(std::shared_ptr<primary_interface::PrimaryPacka
   {
     // URCL_LOG_INFO("%s", product->toString().c_str());
     //
+    std::lock_guard<std::mutex> lock(check_mutex_);
     matches_ = kin_info->toHash() == expected_hash_;
 
     checked_ = true;
+    check_cv_.notify_all();
   }
 
   return true;
 }
+
+bool CalibrationChecker::waitForCheck(const std::chrono::milliseconds timeout)
+{
+  std::unique_lock<std::mutex> lock(check_mutex_);
+  check_cv_.wait_for(lock, timeout, [this]() { return checked_ || cancelled_; });
+  return checked_;
+}
+
+void CalibrationChecker::cancel()
+{
+  std::lock_guard<std::mutex> lock(check_mutex_);
+  cancelled_ = true;
+  check_cv_.notify_all();
+}
 }  // namespace urcl
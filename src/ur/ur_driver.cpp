@@ -34,6 +34,7 @@
 #include "ur_client_library/ur/ur_driver.h"
 #include "ur_client_library/exceptions.h"
 #include "ur_client_library/primary/primary_parser.h"
+#include <future>
 #include <memory>
 #include <sstream>
 
@@ -44,7 +45,9 @@ namespace urcl
 static const std::string BEGIN_REPLACE("{{BEGIN_REPLACE}}");
 static const std::string JOINT_STATE_REPLACE("{{JOINT_STATE_REPLACE}}");
 static const std::string TIME_REPLACE("{{TIME_REPLACE}}");
+static const std::string STAMP_REPLACE("{{STAMP_REPLACE}}");
 static const std::string SERVO_J_REPLACE("{{SERVO_J_REPLACE}}");
+static const std::string ROBOT_READ_TIMEOUT_REPLACE("{{ROBOT_READ_TIMEOUT_REPLACE}}");
 static const std::string SERVER_IP_REPLACE("{{SERVER_IP_REPLACE}}");
 static const std::string SERVER_PORT_REPLACE("{{SERVER_PORT_REPLACE}}");
 static const std::string TRAJECTORY_PORT_REPLACE("{{TRAJECTORY_SERVER_PORT_REPLACE}}");
@@ -55,6 +58,19 @@ urcl::UrDriver::UrDriver(const std::string& robot_ip, const std::string& script_
                          std::unique_ptr<ToolCommSetup> tool_comm_setup, const uint32_t reverse_port,
                          const uint32_t script_sender_port, int servoj_gain, double servoj_lookahead_time,
                          bool non_blocking_read, const std::string& reverse_ip, const uint32_t trajectory_port)
+  : UrDriver(InitTag{}, "", robot_ip, script_file, output_recipe_file, input_recipe_file, handle_program_state,
+             headless_mode, std::move(tool_comm_setup), reverse_port, script_sender_port, servoj_gain,
+             servoj_lookahead_time, non_blocking_read, reverse_ip, trajectory_port)
+{
+}
+
+urcl::UrDriver::UrDriver(InitTag, const std::string& calibration_checksum, const std::string& robot_ip,
+                         const std::string& script_file, const std::string& output_recipe_file,
+                         const std::string& input_recipe_file, std::function<void(bool)> handle_program_state,
+                         bool headless_mode, std::unique_ptr<ToolCommSetup> tool_comm_setup,
+                         const uint32_t reverse_port, const uint32_t script_sender_port, int servoj_gain,
+                         double servoj_lookahead_time, bool non_blocking_read, const std::string& reverse_ip,
+                         const uint32_t trajectory_port)
   : servoj_time_(0.008)
   , servoj_gain_(servoj_gain)
   , servoj_lookahead_time_(servoj_lookahead_time)
@@ -62,6 +78,8 @@ urcl::UrDriver::UrDriver(const std::string& robot_ip, const std::string& script_
   , robot_ip_(robot_ip)
 {
   URCL_LOG_DEBUG("Initializing urdriver");
+  auto start = std::chrono::steady_clock::now();
+
   URCL_LOG_DEBUG("Initializing RTDE client");
   rtde_client_.reset(new rtde_interface::RTDEClient(robot_ip_, notifier_, output_recipe_file, input_recipe_file));
 
@@ -69,12 +87,56 @@ urcl::UrDriver::UrDriver(const std::string& robot_ip, const std::string& script_
       new comm::URStream<primary_interface::PrimaryPackage>(robot_ip_, urcl::primary_interface::UR_PRIMARY_PORT));
   secondary_stream_.reset(
       new comm::URStream<primary_interface::PrimaryPackage>(robot_ip_, urcl::primary_interface::UR_SECONDARY_PORT));
-  secondary_stream_->connect();
 
   non_blocking_read_ = non_blocking_read;
   get_packet_timeout_ = non_blocking_read_ ? 0 : 100;
 
-  if (!rtde_client_->init())
+  // The connections to the robot and the local servers don't depend on each other, so they are set
+  // up concurrently. Only rendering the script needs the results of the RTDE handshake.
+  CalibrationChecker calibration_checker(calibration_checksum);
+  std::future<bool> calibration_check;
+  if (!calibration_checksum.empty())
+  {
+    calibration_check = std::async(std::launch::async, [this, &calibration_checker]() {
+      return measureDuration(startup_timings_.calibration_check, [&]() {
+        return runCalibrationCheck(calibration_checker, std::chrono::milliseconds(10000));
+      });
+    });
+  }
+  auto rtde_init = std::async(std::launch::async, [this]() {
+    return measureDuration(startup_timings_.rtde_init, [this]() { return rtde_client_->init(); });
+  });
+  auto secondary_connect = std::async(std::launch::async, [this]() {
+    return measureDuration(startup_timings_.secondary_connect, [this]() { return secondary_stream_->connect(); });
+  });
+  auto script = std::async(std::launch::async, [this, &script_file]() {
+    return measureDuration(startup_timings_.script_reading, [&]() { return readScriptFile(script_file); });
+  });
+
+  // If the setup fails early, the pending tasks have to finish quickly, as leaving this scope waits
+  // for them. This is destroyed before the futures, so it interrupts them before they are waited for.
+  struct StartupCanceler
+  {
+    std::function<void()> cancel;
+    ~StartupCanceler()
+    {
+      if (cancel)
+      {
+        cancel();
+      }
+    }
+  } startup_canceler{ [this, &calibration_checker]() {
+    secondary_stream_->cancelSetup();
+    primary_stream_->cancelSetup();
+    calibration_checker.cancel();
+  } };
+
+  measureDuration(startup_timings_.servers, [&]() {
+    reverse_interface_.reset(new control::ReverseInterface(reverse_port, handle_program_state));
+    trajectory_interface_.reset(new control::TrajectoryPointInterface(trajectory_port));
+  });
+
+  if (!rtde_init.get())
   {
     throw UrException("Initialization of RTDE client went wrong.");
   }
@@ -85,7 +147,8 @@ urcl::UrDriver::UrDriver(const std::string& robot_ip, const std::string& script_
   // Figure out the ip automatically if the user didn't provide it
   std::string local_ip = reverse_ip.empty() ? rtde_client_->getIP() : reverse_ip;
 
-  std::string prog = readScriptFile(script_file);
+  std::string prog = script.get();
+  auto render_start = std::chrono::steady_clock::now();
   while (prog.find(JOINT_STATE_REPLACE) != std::string::npos)
   {
     prog.replace(prog.find(JOINT_STATE_REPLACE), JOINT_STATE_REPLACE.length(),
@@ -96,6 +159,17 @@ urcl::UrDriver::UrDriver(const std::string& robot_ip, const std::string& script_
     prog.replace(prog.find(TIME_REPLACE), TIME_REPLACE.length(),
                  std::to_string(control::TrajectoryPointInterface::MULT_TIME));
   }
+  while (prog.find(STAMP_REPLACE) != std::string::npos)
+  {
+    prog.replace(prog.find(STAMP_REPLACE), STAMP_REPLACE.length(),
+                 std::to_string(control::ReverseInterface::MULT_STAMP));
+  }
+
+  while (prog.find(ROBOT_READ_TIMEOUT_REPLACE) != std::string::npos)
+  {
+    prog.replace(prog.find(ROBOT_READ_TIMEOUT_REPLACE), ROBOT_READ_TIMEOUT_REPLACE.length(),
+                 std::to_string(std::chrono::duration<double>(control::ReverseInterface::ROBOT_READ_TIMEOUT).count()));
+  }
 
   std::ostringstream out;
   out << "lookahead_time=" << servoj_lookahead_time_ << ", gain=" << servoj_gain_;
@@ -141,6 +215,14 @@ urcl::UrDriver::UrDriver(const std::string& robot_ip, const std::string& script_
   }
   prog.replace(prog.find(BEGIN_REPLACE), BEGIN_REPLACE.length(), begin_replace.str());
 
+  startup_timings_.script_rendering =
+      std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - render_start);
+
+  if (!secondary_connect.get())
+  {
+    throw UrException("Could not connect to the robot's secondary interface.");
+  }
+
   in_headless_mode_ = headless_mode;
   if (in_headless_mode_)
   {
@@ -160,10 +242,22 @@ urcl::UrDriver::UrDriver(const std::string& robot_ip, const std::string& script_
     URCL_LOG_DEBUG("Created script sender");
   }
 
-  reverse_interface_.reset(new control::ReverseInterface(reverse_port, handle_program_state));
-  trajectory_interface_.reset(new control::TrajectoryPointInterface(trajectory_port));
+  if (calibration_check.valid())
+  {
+    try
+    {
+      logCalibrationResult(calibration_check.get());
+    }
+    catch (const UrException& e)
+    {
+      URCL_LOG_ERROR("Could not check the robot's calibration: %s", e.what());
+    }
+  }
+  startup_canceler.cancel = nullptr;
 
-  URCL_LOG_DEBUG("Initialization done");
+  startup_timings_.total =
+      std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+  URCL_LOG_DEBUG("Initialization done after %ld us", startup_timings_.total.count());
 }
 
 urcl::UrDriver::UrDriver(const std::string& robot_ip, const std::string& script_file,
@@ -173,15 +267,39 @@ urcl::UrDriver::UrDriver(const std::string& robot_ip, const std::string& script_
                          const uint32_t reverse_port, const uint32_t script_sender_port, int servoj_gain,
                          double servoj_lookahead_time, bool non_blocking_read, const std::string& reverse_ip,
                          const uint32_t trajectory_port)
-  : UrDriver(robot_ip, script_file, output_recipe_file, input_recipe_file, handle_program_state, headless_mode,
-             std::move(tool_comm_setup), reverse_port, script_sender_port, servoj_gain, servoj_lookahead_time,
-             non_blocking_read, reverse_ip, trajectory_port)
+  : UrDriver(InitTag{}, calibration_checksum, robot_ip, script_file, output_recipe_file, input_recipe_file,
+             handle_program_state, headless_mode, std::move(tool_comm_setup), reverse_port, script_sender_port,
+             servoj_gain, servoj_lookahead_time, non_blocking_read, reverse_ip, trajectory_port)
 {
   URCL_LOG_WARN("DEPRECATION NOTICE: Passing the calibration_checksum to the UrDriver's constructor has been "
                 "deprecated. Instead, use the checkCalibration(calibration_checksum) function separately. This "
                 "notice is for application developers using this library. If you are only using an application using "
                 "this library, you can ignore this message.");
-  if (checkCalibration(calibration_checksum))
+}
+
+std::future<std::unique_ptr<UrDriver>>
+UrDriver::create(const std::string& robot_ip, const std::string& script_file, const std::string& output_recipe_file,
+                 const std::string& input_recipe_file, std::function<void(bool)> handle_program_state,
+                 bool headless_mode, std::unique_ptr<ToolCommSetup> tool_comm_setup,
+                 const std::string& calibration_checksum, const uint32_t reverse_port,
+                 const uint32_t script_sender_port, int servoj_gain, double servoj_lookahead_time,
+                 bool non_blocking_read, const std::string& reverse_ip, const uint32_t trajectory_port)
+{
+  return std::async(
+      std::launch::async,
+      [=](std::unique_ptr<ToolCommSetup> tool_comm) {
+        return std::unique_ptr<UrDriver>(new UrDriver(InitTag{}, calibration_checksum, robot_ip, script_file,
+                                                      output_recipe_file, input_recipe_file, handle_program_state,
+                                                      headless_mode, std::move(tool_comm), reverse_port,
+                                                      script_sender_port, servoj_gain, servoj_lookahead_time,
+                                                      non_blocking_read, reverse_ip, trajectory_port));
+      },
+      std::move(tool_comm_setup));
+}
+
+void UrDriver::logCalibrationResult(const bool calibration_matches) const
+{
+  if (calibration_matches)
   {
     URCL_LOG_INFO("Calibration checked successfully.");
   }
@@ -211,12 +329,69 @@ bool UrDriver::writeJointCommand(const vector6d_t& values, const comm::ControlMo
   return reverse_interface_->write(&values, control_mode);
 }
 
+void UrDriver::startSetpointSender(const control::RealtimeConfig& config, const uint32_t keepalive_cycles)
+{
+  stopSetpointSender();
+  setpoint_sender_.reset(new control::SetpointSender(
+      *reverse_interface_, std::chrono::nanoseconds(1000000000 / rtde_frequency_), keepalive_cycles));
+  setpoint_sender_->start(config);
+}
+
+void UrDriver::stopSetpointSender()
+{
+  if (setpoint_sender_)
+  {
+    setpoint_sender_->stop();
+    setpoint_sender_.reset();
+  }
+}
+
+bool UrDriver::publishJointCommand(const vector6d_t& values, const comm::ControlMode control_mode)
+{
+  if (!setpoint_sender_)
+  {
+    return false;
+  }
+  setpoint_sender_->publish(values, control_mode);
+  return true;
+}
+
+bool UrDriver::writeForceCommand(const vector6d_t& wrench, const vector6uint32_t& selection, const vector6d_t& limits,
+                                 const vector6d_t& task_frame, const control::ForceModeType type)
+{
+  return reverse_interface_->writeForceCommand(wrench, selection, limits, task_frame, type);
+}
+
 bool UrDriver::writeTrajectoryPoint(const vector6d_t& values, const bool cartesian, const float goal_time,
                                     const float blend_radius)
 {
   return trajectory_interface_->writeTrajectoryPoint(&values, goal_time, blend_radius, cartesian);
 }
 
+bool UrDriver::writeTrajectoryPoints(const vector6d_t* positions, const float* goal_times, const float* blend_radii,
+                                     const size_t num_points, const bool cartesian)
+{
+  return trajectory_interface_->writeTrajectoryPoints(positions, goal_times, blend_radii, num_points, cartesian);
+}
+
+bool UrDriver::writeTrajectoryPoints(const control::TrajectoryPoint* points, const size_t num_points,
+                                     const bool cartesian)
+{
+  return trajectory_interface_->writeTrajectoryPoints(points, num_points, cartesian);
+}
+
+bool UrDriver::streamTrajectory(const vector6d_t* positions, const float* goal_times, const float* blend_radii,
+                                const size_t num_points, const bool cartesian, const size_t window)
+{
+  // The robot may report progress right after the start message, so that must not be reset anymore.
+  trajectory_interface_->resetProgress();
+  if (!writeTrajectoryControlMessage(control::TrajectoryControlMessage::TRAJECTORY_START, num_points))
+  {
+    return false;
+  }
+  return trajectory_interface_->streamTrajectory(positions, goal_times, blend_radii, num_points, cartesian, window);
+}
+
 bool UrDriver::writeTrajectoryControlMessage(const control::TrajectoryControlMessage trajectory_action,
                                              const int point_number)
 {
@@ -248,26 +423,33 @@ std::string UrDriver::readScriptFile(const std::string& filename)
   return content;
 }
 
-bool UrDriver::checkCalibration(const std::string& checksum)
+bool UrDriver::checkCalibration(const std::string& checksum, const std::chrono::milliseconds timeout)
 {
   if (primary_stream_ == nullptr)
   {
     throw std::runtime_error("checkCalibration() called without a primary interface connection being established.");
   }
+  CalibrationChecker consumer(checksum);
+  return runCalibrationCheck(consumer, timeout);
+}
+
+bool UrDriver::runCalibrationCheck(CalibrationChecker& consumer, const std::chrono::milliseconds timeout)
+{
   primary_interface::PrimaryParser parser;
   comm::URProducer<primary_interface::PrimaryPackage> prod(*primary_stream_, parser);
   prod.setupProducer();
 
-  CalibrationChecker consumer(checksum);
-
   comm::INotifier notifier;
 
   comm::Pipeline<primary_interface::PrimaryPackage> pipeline(prod, &consumer, "Pipeline", notifier);
   pipeline.run();
 
-  while (!consumer.isChecked())
+  if (!consumer.waitForCheck(timeout))
   {
-    std::this_thread::sleep_for(std::chrono::seconds(1));
+    timeval tv;
+    tv.tv_sec = timeout.count() / 1000;
+    tv.tv_usec = (timeout.count() % 1000) * 1000;
+    throw TimeoutException("Did not receive calibration information from the robot in time. ", tv);
   }
   URCL_LOG_DEBUG("Got calibration information from robot.");
   return consumer.checkSuccessful();
@@ -327,4 +509,13 @@ void UrDriver::setKeepaliveCount(const uint32_t& count)
 {
   reverse_interface_->setKeepaliveCount(count);
 }
+
+void UrDriver::setKeepaliveConfig(const comm::KeepaliveConfig& config)
+{
+  rtde_client_->setKeepaliveConfig(config);
+  primary_stream_->setKeepaliveConfig(config);
+  secondary_stream_->setKeepaliveConfig(config);
+  reverse_interface_->setKeepaliveConfig(config);
+  trajectory_interface_->setKeepaliveConfig(config);
+}
 }  // namespace urcl
@@ -0,0 +1,69 @@
+// -- BEGIN LICENSE BLOCK ----------------------------------------------
+// Copyright 2026 Universal Robots A/S
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -- END LICENSE BLOCK ------------------------------------------------
+
+#include <gtest/gtest.h>
+#include <chrono>
+
+#include <ur_client_library/comm/connection_health.h>
+
+using namespace urcl;
+
+class ConnectionHealthTest : public ::testing::Test
+{
+protected:
+  void SetUp()
+  {
+    monitor_.setTimeouts(std::chrono::milliseconds(50), std::chrono::milliseconds(100));
+  }
+
+  comm::ConnectionHealthMonitor monitor_;
+  comm::ConnectionHealthMonitor::Clock::time_point start_ = comm::ConnectionHealthMonitor::Clock::now();
+};
+
+TEST_F(ConnectionHealthTest, escalates_after_silence)
+{
+  EXPECT_EQ(monitor_.check(start_ + std::chrono::seconds(1)), comm::ConnectionHealth::UNKNOWN);
+
+  monitor_.notifyReceived(start_);
+  EXPECT_EQ(monitor_.check(start_ + std::chrono::milliseconds(10)), comm::ConnectionHealth::HEALTHY);
+  EXPECT_EQ(monitor_.check(start_ + std::chrono::milliseconds(60)), comm::ConnectionHealth::STALE);
+  EXPECT_EQ(monitor_.check(start_ + std::chrono::milliseconds(110)), comm::ConnectionHealth::LOST);
+}
+
+TEST_F(ConnectionHealthTest, stray_data_while_suspended_is_ignored)
+{
+  monitor_.notifyReceived(start_);
+  monitor_.suspend();
+  EXPECT_EQ(monitor_.getHealth(), comm::ConnectionHealth::UNKNOWN);
+
+  // A stray package followed by silence must not be considered a lost link.
+  monitor_.notifyReceived(start_ + std::chrono::milliseconds(10));
+  EXPECT_EQ(monitor_.getHealth(), comm::ConnectionHealth::UNKNOWN);
+  EXPECT_EQ(monitor_.check(start_ + std::chrono::seconds(1)), comm::ConnectionHealth::UNKNOWN);
+
+  // After resuming, only new data arms the monitor again.
+  monitor_.resume();
+  EXPECT_EQ(monitor_.check(start_ + std::chrono::seconds(2)), comm::ConnectionHealth::UNKNOWN);
+  monitor_.notifyReceived(start_ + std::chrono::seconds(2));
+  EXPECT_EQ(monitor_.check(start_ + std::chrono::seconds(3)), comm::ConnectionHealth::LOST);
+}
+
+int main(int argc, char* argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+
+  return RUN_ALL_TESTS();
+}
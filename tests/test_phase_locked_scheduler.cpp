@@ -0,0 +1,124 @@
+// -- BEGIN LICENSE BLOCK ----------------------------------------------
+// Copyright 2026 Universal Robots A/S
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -- END LICENSE BLOCK ------------------------------------------------
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <ur_client_library/control/phase_locked_scheduler.h>
+
+using namespace urcl;
+
+TEST(PhaseLockedSchedulerTest, predicts_package_arrival)
+{
+  const auto period = std::chrono::microseconds(2000);
+  control::PhaseLockedScheduler scheduler(period, std::chrono::microseconds(300));
+
+  std::chrono::steady_clock::time_point tick;
+  EXPECT_FALSE(scheduler.predictTick(std::chrono::steady_clock::now(), tick));
+
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < 100; ++i)
+  {
+    // Alternating network jitter of 50us
+    scheduler.onPackage(start + i * period + std::chrono::microseconds(i % 2 * 50));
+  }
+
+  ASSERT_TRUE(scheduler.predictTick(start + 100 * period - std::chrono::microseconds(500), tick));
+  const double error_us = std::chrono::duration<double, std::micro>(tick - (start + 100 * period)).count();
+  EXPECT_NEAR(error_us, 0.0, 60.0);
+}
+
+TEST(PhaseLockedSchedulerTest, tracks_period_and_lost_packages)
+{
+  // The robot's clock runs slightly faster than nominal
+  const auto actual_period = std::chrono::microseconds(1990);
+  control::PhaseLockedScheduler scheduler(std::chrono::microseconds(2000), std::chrono::microseconds(300));
+
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < 5000; ++i)
+  {
+    if (i % 7 == 3)
+    {
+      continue;
+    }
+    scheduler.onPackage(start + i * actual_period);
+  }
+  EXPECT_NEAR(scheduler.getPeriod().count(), 1990000, 1000);
+}
+
+TEST(PhaseLockedSchedulerTest, calls_callback_once_per_cycle)
+{
+  const auto period = std::chrono::milliseconds(10);
+  control::PhaseLockedScheduler scheduler(period, std::chrono::milliseconds(2));
+
+  std::atomic<int> calls(0);
+  scheduler.start([&calls]() { ++calls; });
+  scheduler.onPackage(std::chrono::steady_clock::now());
+  std::this_thread::sleep_for(std::chrono::milliseconds(105));
+  scheduler.stop();
+
+  EXPECT_GE(calls, 8);
+  EXPECT_LE(calls, 11);
+  EXPECT_EQ(scheduler.getStatistics().cycles, static_cast<uint64_t>(calls));
+  EXPECT_GT(scheduler.getStatistics().max_margin.count(), 0);
+}
+
+TEST(PhaseLockedSchedulerTest, missing_receive_time_uses_current_time)
+{
+  const auto period = std::chrono::milliseconds(8);
+  control::PhaseLockedScheduler scheduler(period, std::chrono::milliseconds(1));
+
+  const auto before = std::chrono::steady_clock::now();
+  scheduler.onPackage(std::chrono::system_clock::time_point());
+
+  std::chrono::steady_clock::time_point tick;
+  ASSERT_TRUE(scheduler.predictTick(before, tick));
+  EXPECT_GE(tick, before);
+  EXPECT_LE(tick, std::chrono::steady_clock::now() + period);
+}
+
+TEST(PhaseLockedSchedulerTest, reset_forgets_phase_and_period)
+{
+  const auto actual_period = std::chrono::microseconds(1990);
+  control::PhaseLockedScheduler scheduler(std::chrono::microseconds(2000), std::chrono::microseconds(300));
+
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < 5000; ++i)
+  {
+    scheduler.onPackage(start + i * actual_period);
+  }
+  ASSERT_LT(scheduler.getPeriod().count(), 1995000);
+
+  scheduler.reset();
+  std::chrono::steady_clock::time_point tick;
+  EXPECT_FALSE(scheduler.predictTick(std::chrono::steady_clock::now(), tick));
+  EXPECT_EQ(scheduler.getPeriod().count(), 2000000);
+
+  // The next package starts a new phase
+  const auto restart = std::chrono::steady_clock::now();
+  scheduler.onPackage(restart);
+  ASSERT_TRUE(scheduler.predictTick(restart, tick));
+  EXPECT_EQ(tick, restart + std::chrono::microseconds(2000));
+}
+
+int main(int argc, char* argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+
+  return RUN_ALL_TESTS();
+}
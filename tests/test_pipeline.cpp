@@ -0,0 +1,98 @@
+// -- BEGIN LICENSE BLOCK ----------------------------------------------
+// Copyright 2026 Universal Robots A/S
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -- END LICENSE BLOCK ------------------------------------------------
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <thread>
+
+#include <ur_client_library/comm/pipeline.h>
+
+using namespace urcl;
+
+class CountingConsumer : public comm::IConsumer<int>
+{
+public:
+  bool consume(std::shared_ptr<int> product)
+  {
+    received_.push_back(*product);
+    return true;
+  }
+
+  std::vector<int> received_;
+};
+
+TEST(RateLimitedConsumerTest, every_nth)
+{
+  CountingConsumer consumer;
+  comm::RateLimitedConsumer<int> limiter(consumer, comm::RatePolicy::everyNth(3));
+  for (int i = 0; i < 7; ++i)
+  {
+    EXPECT_TRUE(limiter.consume(std::make_shared<int>(i)));
+  }
+  EXPECT_EQ(consumer.received_, std::vector<int>({ 0, 3, 6 }));
+}
+
+TEST(RateLimitedConsumerTest, min_period)
+{
+  CountingConsumer consumer;
+  comm::RateLimitedConsumer<int> limiter(consumer, comm::RatePolicy::minPeriod(std::chrono::milliseconds(20)));
+  limiter.consume(std::make_shared<int>(0));
+  limiter.consume(std::make_shared<int>(1));
+  std::this_thread::sleep_for(std::chrono::milliseconds(30));
+  limiter.consume(std::make_shared<int>(2));
+  limiter.consume(std::make_shared<int>(3));
+  EXPECT_EQ(consumer.received_, std::vector<int>({ 0, 2 }));
+}
+
+TEST(RateLimitedConsumerTest, latest_at_period)
+{
+  CountingConsumer consumer;
+  comm::RateLimitedConsumer<int> limiter(consumer,
+                                         comm::RatePolicy::latestAtPeriod(std::chrono::milliseconds(20)));
+  limiter.consume(std::make_shared<int>(0));
+  limiter.consume(std::make_shared<int>(1));
+  limiter.consume(std::make_shared<int>(2));
+  limiter.onTimeout();
+  EXPECT_EQ(consumer.received_, std::vector<int>({ 0 }));
+
+  // Without new products, the latest pending one is released on timeout
+  std::this_thread::sleep_for(std::chrono::milliseconds(30));
+  limiter.onTimeout();
+  EXPECT_EQ(consumer.received_, std::vector<int>({ 0, 2 }));
+  limiter.onTimeout();
+  EXPECT_EQ(consumer.received_, std::vector<int>({ 0, 2 }));
+}
+
+TEST(RateLimitedConsumerTest, multi_consumer_applies_policy_per_consumer)
+{
+  CountingConsumer all;
+  CountingConsumer every_second;
+  comm::MultiConsumer<int> multi_consumer({ &all });
+  multi_consumer.addConsumer(&every_second, comm::RatePolicy::everyNth(2));
+  for (int i = 0; i < 4; ++i)
+  {
+    multi_consumer.consume(std::make_shared<int>(i));
+  }
+  EXPECT_EQ(all.received_, std::vector<int>({ 0, 1, 2, 3 }));
+  EXPECT_EQ(every_second.received_, std::vector<int>({ 0, 2 }));
+}
+
+int main(int argc, char* argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,256 @@
+// -- BEGIN LICENSE BLOCK ----------------------------------------------
+// Copyright 2026 Universal Robots A/S
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -- END LICENSE BLOCK ------------------------------------------------
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <condition_variable>
+#include <chrono>
+#include <thread>
+
+#include <ur_client_library/comm/pipeline.h>
+#include <ur_client_library/comm/producer.h>
+#include <ur_client_library/comm/stream.h>
+#include <ur_client_library/comm/tcp_server.h>
+#include <ur_client_library/rtde/rtde_parser.h>
+
+using namespace urcl;
+
+class URProducerTest : public ::testing::Test
+{
+protected:
+  void SetUp()
+  {
+    // Let the operating system pick a free port, so tests can run in parallel.
+    server_.reset(new comm::TCPServer(0));
+    port_ = server_->getPort();
+    // Connections beyond the first one will be closed by the server right away.
+    server_->setMaxClientsAllowed(1);
+    server_->setConnectCallback(std::bind(&URProducerTest::connectionCallback, this, std::placeholders::_1));
+    server_->start();
+
+    stream_.reset(new comm::URStream<rtde_interface::RTDEPackage>("127.0.0.1", port_));
+    parser_.reset(new rtde_interface::RTDEParser({ "timestamp" }));
+    producer_.reset(new comm::URProducer<rtde_interface::RTDEPackage>(*stream_, *parser_));
+    producer_->setStateCallback(std::bind(&URProducerTest::stateCallback, this, std::placeholders::_1));
+    pipeline_.reset(new comm::Pipeline<rtde_interface::RTDEPackage>(*producer_, "test", notifier_));
+  }
+
+  void TearDown()
+  {
+    pipeline_.reset();
+    blocker_.reset();
+    server_.reset();
+  }
+
+  // Occupies the server's only client slot, so the producer's connection gets closed.
+  void blockServer()
+  {
+    blocker_.reset(new comm::URStream<rtde_interface::RTDEPackage>("127.0.0.1", port_));
+    ASSERT_TRUE(blocker_->connect());
+  }
+
+  void connectionCallback(const int filedescriptor)
+  {
+    std::lock_guard<std::mutex> lk(state_mutex_);
+    if (client_fd_ < 0)
+    {
+      client_fd_ = filedescriptor;
+    }
+    connected_fds_.push_back(filedescriptor);
+    state_cv_.notify_one();
+  }
+
+  // Waits for the server to accept a client other than the first one and returns its file descriptor.
+  int waitForNextClient(const std::chrono::milliseconds timeout)
+  {
+    std::unique_lock<std::mutex> lk(state_mutex_);
+    if (!state_cv_.wait_for(lk, timeout, [this]() { return connected_fds_.size() > 1; }))
+    {
+      return -1;
+    }
+    return connected_fds_.back();
+  }
+
+  bool waitForClient(const std::chrono::milliseconds timeout)
+  {
+    std::unique_lock<std::mutex> lk(state_mutex_);
+    return state_cv_.wait_for(lk, timeout, [this]() { return client_fd_ >= 0; });
+  }
+
+  void stateCallback(const comm::ProducerState state)
+  {
+    std::lock_guard<std::mutex> lk(state_mutex_);
+    states_.push_back(state);
+    state_cv_.notify_one();
+  }
+
+  bool waitForState(const comm::ProducerState state, const std::chrono::milliseconds timeout)
+  {
+    std::unique_lock<std::mutex> lk(state_mutex_);
+    return state_cv_.wait_for(lk, timeout, [this, state]() {
+      return std::find(states_.begin(), states_.end(), state) != states_.end();
+    });
+  }
+
+  int port_ = 0;
+  std::atomic<int> client_fd_{ -1 };
+  std::unique_ptr<comm::TCPServer> server_;
+  std::unique_ptr<comm::URStream<rtde_interface::RTDEPackage>> blocker_;
+  std::unique_ptr<comm::URStream<rtde_interface::RTDEPackage>> stream_;
+  std::unique_ptr<rtde_interface::RTDEParser> parser_;
+  std::unique_ptr<comm::URProducer<rtde_interface::RTDEPackage>> producer_;
+  comm::INotifier notifier_;
+  std::unique_ptr<comm::Pipeline<rtde_interface::RTDEPackage>> pipeline_;
+
+private:
+  std::vector<comm::ProducerState> states_;
+  std::vector<int> connected_fds_;
+  std::condition_variable state_cv_;
+  std::mutex state_mutex_;
+};
+
+TEST_F(URProducerTest, stop_while_waiting_for_reconnect)
+{
+  comm::ConnectionConfig config;
+  config.initial_backoff = std::chrono::seconds(10);
+  stream_->setConnectionConfig(config);
+
+  blockServer();
+  pipeline_->init();
+  pipeline_->run();
+  ASSERT_TRUE(waitForState(comm::ProducerState::WAITING_FOR_RECONNECT, std::chrono::seconds(1)));
+
+  // Stopping must not wait for the pending reconnection.
+  auto start = std::chrono::steady_clock::now();
+  pipeline_->stop();
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(200));
+}
+
+TEST_F(URProducerTest, reconnect_after_connection_loss)
+{
+  comm::ConnectionConfig config;
+  config.initial_backoff = std::chrono::milliseconds(10);
+  config.max_backoff = std::chrono::milliseconds(50);
+  stream_->setConnectionConfig(config);
+
+  blockServer();
+  pipeline_->init();
+  pipeline_->run();
+  ASSERT_TRUE(waitForState(comm::ProducerState::WAITING_FOR_RECONNECT, std::chrono::seconds(1)));
+  EXPECT_TRUE(waitForState(comm::ProducerState::RECONNECTING, std::chrono::seconds(1)));
+
+  // Free the server's only slot so that the next reconnection attempt succeeds and the connection
+  // is kept. Attempts made before the server noticed the blocker leaving still get closed.
+  blocker_->disconnect();
+  const int producer_fd = waitForNextClient(std::chrono::seconds(2));
+  ASSERT_GE(producer_fd, 0);
+
+  // Data sent over the accepted connection reaches the pipeline
+  const uint8_t package[] = { 0x00, 0x04, 'V', 0x01 };
+  size_t written;
+  ASSERT_TRUE(server_->write(producer_fd, package, sizeof(package), written));
+  std::unique_ptr<rtde_interface::RTDEPackage> product;
+  ASSERT_TRUE(pipeline_->getLatestProduct(product, std::chrono::seconds(2)));
+  EXPECT_EQ(producer_->getState(), comm::ProducerState::CONNECTED);
+  EXPECT_EQ(stream_->getState(), comm::SocketState::Connected);
+}
+
+TEST_F(URProducerTest, reconnect_when_server_goes_silent)
+{
+  comm::ConnectionConfig config;
+  config.initial_backoff = std::chrono::milliseconds(10);
+  config.max_backoff = std::chrono::milliseconds(50);
+  stream_->setConnectionConfig(config);
+  pipeline_->init();
+  pipeline_->run();
+
+  const uint8_t package[] = { 0x00, 0x04, 'V', 0x01 };
+  size_t written;
+  ASSERT_TRUE(waitForClient(std::chrono::seconds(1)));
+  ASSERT_TRUE(server_->write(client_fd_, package, sizeof(package), written));
+  std::unique_ptr<rtde_interface::RTDEPackage> product;
+  ASSERT_TRUE(pipeline_->getLatestProduct(product, std::chrono::seconds(1)));
+
+  // The server keeps the connection open but doesn't send anything anymore, which has to be
+  // detected as a lost connection without any link loss timeout configured.
+  EXPECT_TRUE(waitForState(comm::ProducerState::WAITING_FOR_RECONNECT,
+                           comm::URProducer<rtde_interface::RTDEPackage>::DEFAULT_LINK_LOSS_TIMEOUT +
+                               std::chrono::seconds(1)));
+  EXPECT_GE(waitForNextClient(std::chrono::seconds(2)), 0);
+}
+
+TEST_F(URProducerTest, drop_malformed_package_in_resync_mode)
+{
+  comm::ResyncConfig config;
+  config.enabled = true;
+  producer_->setResyncConfig(config);
+  pipeline_->init();
+  pipeline_->run();
+
+  // Protocol version answer with a trailing byte that doesn't belong to the package
+  const uint8_t malformed[] = { 0x00, 0x05, 'V', 0x01, 0x00 };
+  const uint8_t valid[] = { 0x00, 0x04, 'V', 0x01 };
+  size_t written;
+  ASSERT_TRUE(waitForClient(std::chrono::seconds(1)));
+  ASSERT_TRUE(server_->write(client_fd_, malformed, sizeof(malformed), written));
+  ASSERT_TRUE(server_->write(client_fd_, valid, sizeof(valid), written));
+
+  std::unique_ptr<rtde_interface::RTDEPackage> package;
+  ASSERT_TRUE(pipeline_->getLatestProduct(package, std::chrono::seconds(1)));
+  EXPECT_NE(dynamic_cast<rtde_interface::RequestProtocolVersion*>(package.get()), nullptr);
+  EXPECT_EQ(producer_->getDroppedPackages(), 1u);
+  EXPECT_EQ(producer_->getState(), comm::ProducerState::CONNECTED);
+}
+
+TEST_F(URProducerTest, skip_oversize_package_in_resync_mode)
+{
+  comm::ResyncConfig config;
+  config.enabled = true;
+  producer_->setResyncConfig(config);
+  pipeline_->init();
+  pipeline_->run();
+
+  // A package larger than the producer's buffer, whose payload looks like package headers
+  std::vector<uint8_t> oversize(5000, 0x00);
+  oversize[0] = 0x13;
+  oversize[1] = 0x88;
+  oversize[2] = 'V';
+  for (size_t i = 3; i + 1 < oversize.size(); i += 2)
+  {
+    oversize[i] = 0x00;
+    oversize[i + 1] = 0x03;
+  }
+  const uint8_t valid[] = { 0x00, 0x04, 'V', 0x01 };
+  size_t written;
+  ASSERT_TRUE(waitForClient(std::chrono::seconds(1)));
+  ASSERT_TRUE(server_->write(client_fd_, oversize.data(), oversize.size(), written));
+  ASSERT_TRUE(server_->write(client_fd_, valid, sizeof(valid), written));
+
+  // The oversize package is skipped as a whole, so the stream stays in sync.
+  std::unique_ptr<rtde_interface::RTDEPackage> package;
+  ASSERT_TRUE(pipeline_->getLatestProduct(package, std::chrono::seconds(1)));
+  EXPECT_NE(dynamic_cast<rtde_interface::RequestProtocolVersion*>(package.get()), nullptr);
+  EXPECT_FALSE(pipeline_->getLatestProduct(package, std::chrono::milliseconds(100)));
+  EXPECT_EQ(producer_->getDroppedPackages(), 1u);
+  EXPECT_EQ(producer_->getState(), comm::ProducerState::CONNECTED);
+}
+
+int main(int argc, char* argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+
+  return RUN_ALL_TESTS();
+}
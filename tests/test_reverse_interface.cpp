@@ -0,0 +1,318 @@
+// -- BEGIN LICENSE BLOCK ----------------------------------------------
+// Copyright 2026 Universal Robots A/S
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -- END LICENSE BLOCK ------------------------------------------------
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstring>
+#include <future>
+#include <thread>
+
+#include <ur_client_library/comm/tcp_socket.h>
+#include <ur_client_library/control/reverse_interface.h>
+
+using namespace urcl;
+
+class ReverseInterfaceTest : public ::testing::Test
+{
+protected:
+  class Client : public comm::TCPSocket
+  {
+  public:
+    Client(const int& port)
+    {
+      std::string host = "127.0.0.1";
+      TCPSocket::setup(host, port);
+    }
+
+    // Sends the values, the first split bytes separately
+    void send(const std::vector<int32_t>& values, const size_t split = 0)
+    {
+      std::vector<int32_t> message;
+      for (auto value : values)
+      {
+        message.push_back(htobe32(value));
+      }
+      const uint8_t* bytes = reinterpret_cast<const uint8_t*>(message.data());
+      size_t written;
+      if (split > 0)
+      {
+        TCPSocket::write(bytes, split, written);
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+      }
+      TCPSocket::write(bytes + split, message.size() * sizeof(int32_t) - split, written);
+    }
+
+    // Reads everything that arrives until the stream is idle for 200ms
+    std::vector<int32_t> receive()
+    {
+      timeval tv;
+      tv.tv_sec = 0;
+      tv.tv_usec = 200000;
+      TCPSocket::setReceiveTimeout(tv);
+
+      std::vector<uint8_t> bytes;
+      uint8_t buffer[65536];
+      size_t read = 0;
+      while (TCPSocket::read(buffer, sizeof(buffer), read) && read > 0)
+      {
+        bytes.insert(bytes.end(), buffer, buffer + read);
+      }
+      std::vector<int32_t> values(bytes.size() / sizeof(int32_t));
+      std::memcpy(values.data(), bytes.data(), values.size() * sizeof(int32_t));
+      for (auto& value : values)
+      {
+        value = be32toh(value);
+      }
+      EXPECT_EQ(bytes.size() % sizeof(int32_t), 0u);
+      return values;
+    }
+  };
+
+  void SetUp()
+  {
+    interface_.reset(new control::ReverseInterface(0, [](bool) {}));
+    client_.reset(new Client(interface_->getPort()));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  }
+
+  void TearDown()
+  {
+    client_.reset();
+    interface_.reset();
+  }
+
+  // Packs a servo cycle report like the URScript program does
+  static int32_t report(const int32_t cycle, const int32_t status, const int32_t extrapolations,
+                        const int32_t sequence)
+  {
+    return ((cycle * 4 + status) * 64 + extrapolations) * 65536 + sequence % 65536;
+  }
+
+  std::unique_ptr<control::ReverseInterface> interface_;
+  std::unique_ptr<Client> client_;
+};
+
+TEST_F(ReverseInterfaceTest, servo_telemetry)
+{
+  // Cycle 3 is missing, cycles 4 and 5 were extrapolated, 5 after dropping a stale setpoint. The
+  // first report is split on purpose.
+  client_->send({ report(1, 0, 0, 0), report(2, 0, 0, 0), report(4, 1, 1, 0), report(5, 2, 2, 0),
+                  report(6, 0, 0, 0) },
+                2);
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+  control::ServoTelemetry telemetry = interface_->getServoTelemetry();
+  EXPECT_EQ(telemetry.cycles, 5u);
+  EXPECT_EQ(telemetry.misses, 2u);
+  EXPECT_EQ(telemetry.stale_setpoints, 1u);
+  EXPECT_EQ(telemetry.lost_reports, 1u);
+  EXPECT_EQ(telemetry.max_consecutive_extrapolations, 2u);
+  EXPECT_EQ(telemetry.extrapolation_histogram[0], 3u);
+  EXPECT_EQ(telemetry.extrapolation_histogram[1], 1u);
+  EXPECT_EQ(telemetry.extrapolation_histogram[2], 1u);
+
+  uint64_t intervals = 0;
+  for (auto count : telemetry.interval_histogram)
+  {
+    intervals += count;
+  }
+  EXPECT_EQ(intervals, 4u);
+
+  interface_->resetServoTelemetry();
+  EXPECT_EQ(interface_->getServoTelemetry().cycles, 0u);
+}
+
+TEST_F(ReverseInterfaceTest, servo_telemetry_counter_wraps)
+{
+  // Cycle 1 after the wrap is missing, extrapolation counts saturate.
+  client_->send({ report(126, 1, 63, 0), report(127, 1, 63, 0), report(0, 0, 0, 0), report(2, 0, 0, 0) });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+  control::ServoTelemetry telemetry = interface_->getServoTelemetry();
+  EXPECT_EQ(telemetry.cycles, 4u);
+  EXPECT_EQ(telemetry.misses, 2u);
+  EXPECT_EQ(telemetry.lost_reports, 1u);
+  EXPECT_EQ(telemetry.max_consecutive_extrapolations, 63u);
+}
+
+TEST_F(ReverseInterfaceTest, write_encodes_command_frame)
+{
+  vector6d_t positions = { 1.0, -2.0, 0.5, 0.0, 3.25, -0.5 };
+  interface_->setKeepaliveCount(5);
+  ASSERT_TRUE(interface_->write(&positions, comm::ControlMode::MODE_SERVOJ));
+  ASSERT_TRUE(interface_->write(nullptr, comm::ControlMode::MODE_IDLE));
+
+  std::vector<int32_t> received = client_->receive();
+  ASSERT_EQ(received.size(), 16u);
+
+  std::vector<int32_t> expected = { 5, 1000000, -2000000, 500000, 0, 3250000, -500000, 1 };
+  EXPECT_EQ(std::vector<int32_t>(received.begin(), received.begin() + 8), expected);
+  expected = { 5, 0, 0, 0, 0, 0, 0, 0 };
+  EXPECT_EQ(std::vector<int32_t>(received.begin() + 8, received.begin() + 16), expected);
+}
+
+TEST_F(ReverseInterfaceTest, write_stamps_timestamped_frames)
+{
+  vector6d_t positions = { 1.0, -2.0, 0.5, 0.0, 3.25, -0.5 };
+  ASSERT_TRUE(interface_->write(&positions, comm::ControlMode::MODE_SERVOJ_TIMESTAMPED));
+  ASSERT_TRUE(interface_->write(&positions, comm::ControlMode::MODE_SERVOJ));
+  ASSERT_TRUE(interface_->write(&positions, comm::ControlMode::MODE_SERVOJ_TIMESTAMPED));
+
+  std::vector<int32_t> received = client_->receive();
+  ASSERT_EQ(received.size(), 10u + 8u + 10u);
+  EXPECT_EQ(received[7], toUnderlying(comm::ControlMode::MODE_SERVOJ_TIMESTAMPED));
+  EXPECT_EQ(received[10 + 7], toUnderlying(comm::ControlMode::MODE_SERVOJ));
+  EXPECT_EQ(received[18 + 7], toUnderlying(comm::ControlMode::MODE_SERVOJ_TIMESTAMPED));
+
+  // Sequence numbers count up, send times are microseconds since the connection.
+  EXPECT_EQ(received[8], 1);
+  EXPECT_EQ(received[18 + 8], 2);
+  EXPECT_GT(received[9], 0);
+  EXPECT_GE(received[18 + 9], received[9]);
+  EXPECT_LT(received[18 + 9], 10000000);
+}
+
+TEST_F(ReverseInterfaceTest, write_force_command_appends_parameters)
+{
+  vector6d_t wrench = { 0.0, 0.0, -10.0, 0.0, 0.0, 0.5 };
+  vector6uint32_t selection = { 0, 0, 1, 0, 0, 1 };
+  vector6d_t limits = { 0.1, 0.1, 0.05, 0.2, 0.2, 0.3 };
+  vector6d_t task_frame = { 0.5, -0.25, 0.0, 0.0, 3.0, 0.0 };
+  ASSERT_TRUE(interface_->writeForceCommand(wrench, selection, limits, task_frame, control::ForceModeType::POINT));
+
+  // Streaming only the wrench keeps the parameters, other modes don't send them.
+  wrench[2] = -20.0;
+  ASSERT_TRUE(interface_->write(&wrench, comm::ControlMode::MODE_FORCE));
+  ASSERT_TRUE(interface_->write(nullptr, comm::ControlMode::MODE_IDLE));
+
+  std::vector<int32_t> received = client_->receive();
+  ASSERT_EQ(received.size(), 27u + 27u + 8u);
+
+  std::vector<int32_t> expected = { 1, 0, 0, -10000000, 0, 0, 500000, 7 };
+  EXPECT_EQ(std::vector<int32_t>(received.begin(), received.begin() + 8), expected);
+  // Task frame, selection vector, limits and force mode type
+  std::vector<int32_t> parameters = { 500000, -250000, 0,      0,      3000000, 0,      0, 0, 1, 0, 0, 1,
+                                      100000, 100000,  50000, 200000, 200000,  300000, 1 };
+  EXPECT_EQ(std::vector<int32_t>(received.begin() + 8, received.begin() + 27), parameters);
+
+  EXPECT_EQ(received[27 + 3], -20000000);
+  EXPECT_EQ(received[27 + 7], toUnderlying(comm::ControlMode::MODE_FORCE));
+  EXPECT_EQ(std::vector<int32_t>(received.begin() + 35, received.begin() + 54), parameters);
+
+  EXPECT_EQ(received[54 + 7], toUnderlying(comm::ControlMode::MODE_IDLE));
+}
+
+TEST_F(ReverseInterfaceTest, servo_telemetry_measures_setpoint_age)
+{
+  vector6d_t positions = { 0.1, 0.2, 0.3, 0.4, 0.5, 0.6 };
+  ASSERT_TRUE(interface_->write(&positions, comm::ControlMode::MODE_SERVOJ_TIMESTAMPED));
+  std::vector<int32_t> received = client_->receive();
+  ASSERT_EQ(received.size(), 10u);
+  EXPECT_EQ(received[7], toUnderlying(comm::ControlMode::MODE_SERVOJ_TIMESTAMPED));
+
+  // Echo the setpoint's sequence number as executed in the report, the receive above took 200ms.
+  client_->send({ report(1, 0, 0, received[8]) });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+  control::ServoTelemetry telemetry = interface_->getServoTelemetry();
+  EXPECT_GE(telemetry.last_setpoint_age, std::chrono::milliseconds(200));
+  EXPECT_EQ(telemetry.max_setpoint_age, telemetry.last_setpoint_age);
+  EXPECT_EQ(telemetry.setpoint_age_histogram[control::ServoTelemetry::AGE_BINS - 1], 1u);
+
+  // Unknown sequence numbers don't produce an age
+  client_->send({ report(2, 0, 0, received[8] + 1000) });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_EQ(interface_->getServoTelemetry().setpoint_age_histogram[control::ServoTelemetry::AGE_BINS - 1], 1u);
+}
+
+TEST_F(ReverseInterfaceTest, write_reports_back_pressure)
+{
+  // The client doesn't read, so the socket buffers fill up eventually.
+  vector6d_t positions = { 0.1, 0.2, 0.3, 0.4, 0.5, 0.6 };
+  size_t commands = 0;
+  while (interface_->getBackPressureCount() == 0 && commands < 1000000)
+  {
+    if (interface_->write(&positions, comm::ControlMode::MODE_SERVOJ))
+    {
+      ++commands;
+    }
+  }
+  EXPECT_GT(interface_->getBackPressureCount(), 0u);
+
+  // Partially sent frames are completed, so the robot only ever sees whole frames.
+  std::vector<int32_t> received;
+  while (received.size() < commands * 8)
+  {
+    std::vector<int32_t> chunk = client_->receive();
+    if (chunk.empty())
+    {
+      interface_->write(&positions, comm::ControlMode::MODE_SERVOJ);
+      ++commands;
+      continue;
+    }
+    received.insert(received.end(), chunk.begin(), chunk.end());
+  }
+  ASSERT_EQ(received.size() % 8, 0u);
+  for (size_t i = 0; i < received.size(); i += 8)
+  {
+    EXPECT_EQ(received[i + 1], 100000);
+    EXPECT_EQ(received[i + 7], 1);
+  }
+}
+
+TEST_F(ReverseInterfaceTest, write_completes_partially_sent_frame)
+{
+  // Fill the socket buffers until a frame doesn't fit into them anymore. Timestamped frames don't
+  // divide the kernel's buffer sizes, so the last one is only sent partially.
+  const size_t frame_length = 10;
+  const int32_t mode = static_cast<int32_t>(comm::ControlMode::MODE_SERVOJ_TIMESTAMPED);
+  vector6d_t positions = { 0.1, 0.2, 0.3, 0.4, 0.5, 0.6 };
+  size_t commands = 0;
+  while (interface_->getBackPressureCount() == 0 && commands < 1000000)
+  {
+    interface_->write(&positions, comm::ControlMode::MODE_SERVOJ_TIMESTAMPED);
+    ++commands;
+  }
+  ASSERT_GT(interface_->getBackPressureCount(), 0u);
+
+  // Once the robot reads again, the rest of a partial frame goes out before the next command.
+  auto received = std::async(std::launch::async, [this]() { return client_->receive(); });
+  vector6d_t last = { 0.9, 0.9, 0.9, 0.9, 0.9, 0.9 };
+  const auto start = std::chrono::steady_clock::now();
+  while (!interface_->write(&last, comm::ControlMode::MODE_SERVOJ_TIMESTAMPED))
+  {
+    ASSERT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+  }
+
+  const std::vector<int32_t> values = received.get();
+  ASSERT_GE(values.size(), frame_length);
+  ASSERT_EQ(values.size() % frame_length, 0u);
+  for (size_t i = 0; i + frame_length < values.size(); i += frame_length)
+  {
+    EXPECT_EQ(values[i + 1], 100000);
+    EXPECT_EQ(values[i + 7], mode);
+  }
+  const int32_t* frame = &values[values.size() - frame_length];
+  EXPECT_EQ(frame[1], 900000);
+  EXPECT_EQ(frame[7], mode);
+}
+
+int main(int argc, char* argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,138 @@
+// -- BEGIN LICENSE BLOCK ----------------------------------------------
+// Copyright 2026 Universal Robots A/S
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -- END LICENSE BLOCK ------------------------------------------------
+
+#include <gtest/gtest.h>
+
+#include <ur_client_library/exceptions.h>
+#include <ur_client_library/rtde/change_detector.h>
+
+using namespace urcl;
+
+class ChangeDetectorTest : public ::testing::Test
+{
+protected:
+  void SetUp()
+  {
+    recipe_ = { "actual_q", "actual_digital_input_bits", "robot_mode", "speed_scaling" };
+    package_.reset(new rtde_interface::DataPackage(recipe_));
+    package_->initEmpty();
+  }
+
+  std::vector<std::string> recipe_;
+  std::unique_ptr<rtde_interface::DataPackage> package_;
+};
+
+TEST_F(ChangeDetectorTest, first_sample_is_reference)
+{
+  rtde_interface::ChangeDetector detector(recipe_);
+  EXPECT_FALSE(detector.update(*package_));
+  EXPECT_FALSE(detector.update(*package_));
+  EXPECT_FALSE(detector.hasChanged("actual_q"));
+}
+
+TEST_F(ChangeDetectorTest, detects_changed_fields_and_edges)
+{
+  rtde_interface::ChangeDetector detector(recipe_);
+  uint64_t inputs = 0b0101;
+  package_->setData("actual_digital_input_bits", inputs);
+  detector.update(*package_);
+
+  inputs = 0b0110;
+  package_->setData("actual_digital_input_bits", inputs);
+  vector6d_t q = { 0, 0, 0, 0, 0, 1e-9 };
+  package_->setData("actual_q", q);
+  EXPECT_TRUE(detector.update(*package_));
+
+  EXPECT_TRUE(detector.hasChanged("actual_q"));
+  EXPECT_TRUE(detector.hasChanged("actual_digital_input_bits"));
+  EXPECT_FALSE(detector.hasChanged("robot_mode"));
+  EXPECT_FALSE(detector.hasChanged("speed_scaling"));
+  EXPECT_EQ(detector.getChangedFields()[0], 0b0011u);
+
+  // actual_q isn't integral, so only the inputs report edges
+  ASSERT_EQ(detector.getEdges().size(), 1u);
+  EXPECT_EQ(detector.getEdges()[0].field, 1u);
+  EXPECT_EQ(detector.getEdges()[0].rising, 0b0010u);
+  EXPECT_EQ(detector.getEdges()[0].falling, 0b0001u);
+}
+
+TEST_F(ChangeDetectorTest, subscribers_are_filtered_by_mask)
+{
+  rtde_interface::ChangeDetector detector(recipe_);
+  int mode_calls = 0;
+  int input_calls = 0;
+  detector.subscribe(detector.makeMask({ "robot_mode" }),
+                     [&mode_calls](const rtde_interface::ChangeDetector::FieldMask&,
+                                   const std::vector<rtde_interface::ChangeDetector::FieldEdges>&) { ++mode_calls; });
+  detector.subscribe(detector.makeMask({ "actual_digital_input_bits" }),
+                     [&input_calls](const rtde_interface::ChangeDetector::FieldMask&,
+                                    const std::vector<rtde_interface::ChangeDetector::FieldEdges>&) { ++input_calls; });
+  detector.update(*package_);
+
+  int32_t mode = 7;
+  package_->setData("robot_mode", mode);
+  detector.update(*package_);
+  EXPECT_EQ(mode_calls, 1);
+  EXPECT_EQ(input_calls, 0);
+}
+
+TEST_F(ChangeDetectorTest, missing_field_keeps_previous_value)
+{
+  rtde_interface::ChangeDetector detector(recipe_);
+  int32_t mode = 3;
+  package_->setData("robot_mode", mode);
+  detector.update(*package_);
+  mode = 7;
+  package_->setData("robot_mode", mode);
+  EXPECT_TRUE(detector.update(*package_));
+
+  // A package without robot_mode keeps the previous value of 7
+  rtde_interface::DataPackage partial({ "actual_q", "actual_digital_input_bits", "speed_scaling" });
+  partial.initEmpty();
+  EXPECT_FALSE(detector.update(partial));
+  EXPECT_FALSE(detector.hasChanged("robot_mode"));
+
+  EXPECT_FALSE(detector.update(*package_));
+  mode = 3;
+  package_->setData("robot_mode", mode);
+  EXPECT_TRUE(detector.update(*package_));
+  EXPECT_TRUE(detector.hasChanged("robot_mode"));
+}
+
+TEST_F(ChangeDetectorTest, unknown_field_throws)
+{
+  EXPECT_THROW(rtde_interface::ChangeDetector({ "not_a_field" }), UrException);
+  rtde_interface::ChangeDetector detector(recipe_);
+  EXPECT_THROW(detector.makeMask({ "target_q" }), UrException);
+}
+
+TEST_F(ChangeDetectorTest, mismatched_mask_throws)
+{
+  rtde_interface::ChangeDetector detector(recipe_);
+  auto subscriber = [](const rtde_interface::ChangeDetector::FieldMask&,
+                       const std::vector<rtde_interface::ChangeDetector::FieldEdges>&) {};
+  EXPECT_THROW(detector.subscribe(rtde_interface::ChangeDetector::FieldMask(), subscriber), UrException);
+  EXPECT_THROW(detector.subscribe(rtde_interface::ChangeDetector::FieldMask(2, ~uint64_t(0)), subscriber),
+               UrException);
+  EXPECT_NO_THROW(detector.subscribe(detector.makeMask({ "robot_mode" }), subscriber));
+}
+
+int main(int argc, char* argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,312 @@
+// -- BEGIN LICENSE BLOCK ----------------------------------------------
+// Copyright 2026 Universal Robots A/S
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -- END LICENSE BLOCK ------------------------------------------------
+
+#include <gtest/gtest.h>
+#include <endian.h>
+
+#include <atomic>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include <ur_client_library/comm/tcp_server.h>
+#include <ur_client_library/rtde/multi_rate_rtde_client.h>
+#include <ur_client_library/rtde/rtde_client.h>
+
+using namespace urcl;
+
+// Keeps track of whether the client's pipeline is running
+class RunningNotifier : public comm::INotifier
+{
+public:
+  void started(std::string name) override
+  {
+    running_ = true;
+  }
+  void stopped(std::string name) override
+  {
+    running_ = false;
+  }
+
+  std::atomic<bool> running_{ false };
+};
+
+// Answers RTDE requests like a booted robot with protocol version 2. Every output field is
+// reported as DOUBLE and data packages are streamed every 10 ms between start and pause requests.
+// Each connection is handled separately, so several clients can be served at once.
+class RTDEClientSessionTest : public ::testing::Test
+{
+protected:
+  void SetUp()
+  {
+    server_.reset(new comm::TCPServer(UR_RTDE_PORT));
+    server_->setMessageCallback(std::bind(&RTDEClientSessionTest::messageCallback, this, std::placeholders::_1,
+                                          std::placeholders::_2, std::placeholders::_3));
+    server_->start();
+    streaming_thread_ = std::thread([this]() {
+      while (running_)
+      {
+        {
+          std::lock_guard<std::mutex> lock(mutex_);
+          for (auto& connection : connections_)
+          {
+            if (connection.second.streaming)
+            {
+              sendData(connection.first, connection.second);
+            }
+          }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      }
+    });
+  }
+
+  void TearDown()
+  {
+    client_.reset();
+    running_ = false;
+    streaming_thread_.join();
+    server_.reset();
+  }
+
+  struct Connection
+  {
+    std::vector<uint8_t> received;
+    size_t num_outputs = 1;
+    size_t timestamp_index = 0;
+    bool streaming = false;
+    double timestamp = 100.0;
+    std::vector<rtde_interface::PackageType> requests;
+  };
+
+  void messageCallback(const int fd, char* buffer, int nbytesrecv)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<uint8_t>& received = connections_[fd].received;
+    received.insert(received.end(), buffer, buffer + nbytesrecv);
+    while (received.size() >= 3)
+    {
+      const size_t size = (static_cast<size_t>(received[0]) << 8) | received[1];
+      if (received.size() < size)
+      {
+        break;
+      }
+      handleRequest(fd, static_cast<rtde_interface::PackageType>(received[2]),
+                    std::string(received.begin() + 3, received.begin() + size));
+      received.erase(received.begin(), received.begin() + size);
+    }
+  }
+
+  void handleRequest(const int fd, const rtde_interface::PackageType type, const std::string& payload)
+  {
+    Connection& connection = connections_[fd];
+    connection.requests.push_back(type);
+    switch (type)
+    {
+      case rtde_interface::PackageType::RTDE_REQUEST_PROTOCOL_VERSION:
+        send(fd, type, std::string(1, '\x01'));
+        break;
+      case rtde_interface::PackageType::RTDE_CONTROL_PACKAGE_PAUSE:
+        connection.streaming = false;
+        send(fd, type, std::string(1, '\x01'));
+        break;
+      case rtde_interface::PackageType::RTDE_GET_URCONTROL_VERSION:
+        send(fd, type, std::string("\x00\x00\x00\x05\x00\x00\x00\x0a", 8) + std::string(8, '\x00'));
+        break;
+      case rtde_interface::PackageType::RTDE_CONTROL_PACKAGE_SETUP_OUTPUTS:
+      {
+        // The payload starts with the frequency, followed by the comma separated recipe
+        std::stringstream recipe(payload.substr(sizeof(double)));
+        std::string field;
+        connection.num_outputs = 0;
+        while (std::getline(recipe, field, ','))
+        {
+          if (field == "timestamp")
+          {
+            connection.timestamp_index = connection.num_outputs;
+          }
+          ++connection.num_outputs;
+        }
+        std::string types = "DOUBLE";
+        for (size_t i = 1; i < connection.num_outputs; ++i)
+        {
+          types += ",DOUBLE";
+        }
+        send(fd, type, std::string(1, '\x01') + types);
+        break;
+      }
+      case rtde_interface::PackageType::RTDE_CONTROL_PACKAGE_START:
+        if (connection.num_outputs == reject_start_outputs_)
+        {
+          send(fd, type, std::string(1, '\x00'));
+          break;
+        }
+        send(fd, type, std::string(1, '\x01'));
+        connection.streaming = true;
+        break;
+      default:
+        break;
+    }
+  }
+
+  // Sends a data package with a controller timestamp of a robot that has been up for a while. The
+  // timestamp advances by the streaming period. mutex_ has to be locked.
+  void sendData(const int fd, Connection& connection)
+  {
+    connection.timestamp += 0.01;
+    std::string payload(1, '\x01');
+    for (size_t i = 0; i < connection.num_outputs; ++i)
+    {
+      const double value = i == connection.timestamp_index ? connection.timestamp : 0.0;
+      uint64_t raw;
+      std::memcpy(&raw, &value, sizeof(raw));
+      raw = htobe64(raw);
+      payload.append(reinterpret_cast<const char*>(&raw), sizeof(raw));
+    }
+    send(fd, rtde_interface::PackageType::RTDE_DATA_PACKAGE, payload);
+  }
+
+  void send(const int fd, const rtde_interface::PackageType type, const std::string& payload)
+  {
+    const size_t size = payload.size() + 3;
+    std::string package;
+    package.push_back(static_cast<char>(size >> 8));
+    package.push_back(static_cast<char>(size & 0xff));
+    package.push_back(static_cast<char>(type));
+    package += payload;
+    size_t written;
+    server_->write(fd, reinterpret_cast<const uint8_t*>(package.data()), package.size(), written);
+  }
+
+  // Returns the requests received on the connection whose output recipe has the given size
+  std::vector<rtde_interface::PackageType> getRequests(const size_t num_outputs)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& connection : connections_)
+    {
+      if (connection.second.num_outputs == num_outputs)
+      {
+        return connection.second.requests;
+      }
+    }
+    return {};
+  }
+
+  void clearRequests()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& connection : connections_)
+    {
+      connection.second.requests.clear();
+    }
+  }
+
+  std::unique_ptr<comm::TCPServer> server_;
+  std::unique_ptr<rtde_interface::RTDEClient> client_;
+  RunningNotifier notifier_;
+  // Start requests on connections with this many output fields are rejected
+  std::atomic<size_t> reject_start_outputs_{ 0 };
+
+private:
+  std::mutex mutex_;
+  std::map<int, Connection> connections_;
+  std::atomic<bool> running_{ true };
+  std::thread streaming_thread_;
+};
+
+TEST_F(RTDEClientSessionTest, reconfigure_before_start_keeps_pipeline_stopped)
+{
+  client_.reset(new rtde_interface::RTDEClient("127.0.0.1", notifier_, std::vector<std::string>{ "timestamp" },
+                                               std::vector<std::string>{}));
+  ASSERT_TRUE(client_->init());
+  EXPECT_FALSE(notifier_.running_);
+
+  ASSERT_TRUE(client_->reconfigure({ "timestamp", "speed_scaling" }));
+  EXPECT_FALSE(notifier_.running_);
+  EXPECT_EQ(client_->getOutputRecipe().size(), 2u);
+
+  // Starting afterwards still works with the new recipe
+  ASSERT_TRUE(client_->start());
+  EXPECT_TRUE(notifier_.running_);
+  std::unique_ptr<rtde_interface::DataPackage> package = client_->getDataPackage(std::chrono::seconds(1));
+  ASSERT_NE(package, nullptr);
+  double speed_scaling = 1.0;
+  EXPECT_TRUE(package->getData("speed_scaling", speed_scaling));
+  EXPECT_EQ(speed_scaling, 0.0);
+}
+
+TEST_F(RTDEClientSessionTest, multi_rate_start_failure_pauses_started_streams)
+{
+  // The timestamp is added to every recipe, so the streams have one and two output fields.
+  rtde_interface::MultiRateRTDEClient client("127.0.0.1", notifier_,
+                                             { { { "timestamp" }, 0.0 }, { { "speed_scaling" }, 0.0 } });
+  ASSERT_TRUE(client.init());
+  clearRequests();
+
+  reject_start_outputs_ = 2;
+  EXPECT_FALSE(client.start());
+  const std::vector<rtde_interface::PackageType> expected{ rtde_interface::PackageType::RTDE_CONTROL_PACKAGE_START,
+                                                           rtde_interface::PackageType::RTDE_CONTROL_PACKAGE_PAUSE };
+  EXPECT_EQ(getRequests(1), expected);
+
+  // Fields are only reported once they have been received
+  double timestamp;
+  EXPECT_FALSE(client.getData("timestamp", timestamp));
+
+  reject_start_outputs_ = 0;
+  ASSERT_TRUE(client.start());
+  ASSERT_TRUE(client.waitForUpdate(1, std::chrono::seconds(1)));
+  double speed_scaling = 1.0;
+  EXPECT_TRUE(client.getData("speed_scaling", speed_scaling));
+  EXPECT_EQ(speed_scaling, 0.0);
+  EXPECT_TRUE(client.getData("timestamp", timestamp));
+}
+
+TEST_F(RTDEClientSessionTest, clock_estimator_is_fed_with_data_packages)
+{
+  client_.reset(new rtde_interface::RTDEClient("127.0.0.1", notifier_, std::vector<std::string>{ "timestamp" },
+                                               std::vector<std::string>{}));
+  ASSERT_TRUE(client_->init());
+  EXPECT_FALSE(client_->getClockEstimator().isValid());
+  ASSERT_TRUE(client_->start());
+
+  // Two windows of packages are needed for a valid estimate
+  const auto start = std::chrono::steady_clock::now();
+  while (!client_->getClockEstimator().isValid())
+  {
+    ASSERT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  std::unique_ptr<rtde_interface::DataPackage> package = client_->getDataPackage(std::chrono::seconds(1));
+  ASSERT_NE(package, nullptr);
+  double timestamp = 0.0;
+  ASSERT_TRUE(package->getData("timestamp", timestamp));
+  std::chrono::steady_clock::time_point host_time;
+  std::chrono::nanoseconds error_bound;
+  ASSERT_TRUE(client_->getClockEstimator().robotToHost(timestamp, host_time, error_bound));
+  EXPECT_LT(std::chrono::abs(std::chrono::steady_clock::now() - host_time), std::chrono::seconds(1));
+}
+
+int main(int argc, char* argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+
+  return RUN_ALL_TESTS();
+}
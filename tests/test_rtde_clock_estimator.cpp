@@ -0,0 +1,106 @@
+// -- BEGIN LICENSE BLOCK ----------------------------------------------
+// Copyright 2026 Universal Robots A/S
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -- END LICENSE BLOCK ------------------------------------------------
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <random>
+
+#include <ur_client_library/rtde/clock_estimator.h>
+
+using namespace urcl;
+
+TEST(ClockEstimatorTest, estimates_offset_and_drift)
+{
+  rtde_interface::ClockEstimator estimator(50, 64);
+  const auto host_start = std::chrono::steady_clock::now();
+  const double robot_start = 1234.5;
+  // The host clock runs 20 ppm faster than the robot's, packages are delayed by 0.2 to 2 ms.
+  const double drift = 20e-6;
+  std::mt19937 generator(42);
+  std::exponential_distribution<double> jitter(1.0 / 0.0003);
+
+  auto host_time = [&](double robot_time) {
+    return host_start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                            std::chrono::duration<double>((robot_time - robot_start) * (1.0 + drift)));
+  };
+
+  EXPECT_FALSE(estimator.isValid());
+  for (int i = 0; i < 20000; ++i)
+  {
+    const double robot_time = robot_start + i * 0.002;
+    const auto delay = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(0.0002 + std::min(jitter(generator), 0.0018)));
+    estimator.update(robot_time, host_time(robot_time) + delay);
+  }
+  ASSERT_TRUE(estimator.isValid());
+  EXPECT_NEAR(estimator.getDrift(), drift, 2e-6);
+
+  // Conversions refer to the minimal delay of 0.2 ms
+  const double robot_time = robot_start + 40.0;
+  std::chrono::steady_clock::time_point converted;
+  std::chrono::nanoseconds error_bound;
+  ASSERT_TRUE(estimator.robotToHost(robot_time, converted, error_bound));
+  const double error = std::chrono::duration<double>(converted - host_time(robot_time)).count() - 0.0002;
+  EXPECT_NEAR(error, 0.0, 50e-6);
+  EXPECT_LT(error_bound.count(), 50000);
+
+  double robot_converted;
+  double robot_error_bound;
+  ASSERT_TRUE(estimator.hostToRobot(converted, robot_converted, robot_error_bound));
+  EXPECT_NEAR(robot_converted, robot_time, 1e-6);
+}
+
+TEST(ClockEstimatorTest, restarts_when_robot_time_jumps_back)
+{
+  rtde_interface::ClockEstimator estimator(10, 4);
+  const auto host_start = std::chrono::steady_clock::now();
+  for (int i = 0; i < 100; ++i)
+  {
+    estimator.update(100.0 + i * 0.002, host_start + i * std::chrono::milliseconds(2));
+  }
+  EXPECT_TRUE(estimator.isValid());
+  estimator.update(0.0, host_start + std::chrono::milliseconds(200));
+  EXPECT_FALSE(estimator.isValid());
+}
+
+TEST(ClockEstimatorTest, package_without_receive_time_uses_current_time)
+{
+  rtde_interface::ClockEstimator estimator(1, 2);
+  rtde_interface::DataPackage package({ "timestamp" });
+  package.initEmpty();
+
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < 3; ++i)
+  {
+    double timestamp = 100.0 + i * 0.01;
+    ASSERT_TRUE(package.setData("timestamp", timestamp));
+    ASSERT_TRUE(estimator.update(package));
+  }
+  ASSERT_TRUE(estimator.isValid());
+
+  // Without the fallback the host times would be decades in the past
+  std::chrono::steady_clock::time_point converted;
+  std::chrono::nanoseconds error_bound;
+  ASSERT_TRUE(estimator.robotToHost(100.0, converted, error_bound));
+  EXPECT_LT(std::chrono::abs(converted - start), std::chrono::seconds(1));
+}
+
+int main(int argc, char* argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,176 @@
+// -- BEGIN LICENSE BLOCK ----------------------------------------------
+// Copyright 2026 Universal Robots A/S
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -- END LICENSE BLOCK ------------------------------------------------
+
+#include <gtest/gtest.h>
+#include <chrono>
+
+#include <ur_client_library/rtde/control_channel.h>
+#include <ur_client_library/rtde/control_package_pause.h>
+#include <ur_client_library/rtde/control_package_start.h>
+#include <ur_client_library/rtde/data_package.h>
+#include <ur_client_library/rtde/get_urcontrol_version.h>
+#include <ur_client_library/rtde/text_message.h>
+
+using namespace urcl;
+
+class ControlChannelTest : public ::testing::Test
+{
+protected:
+  template <typename T, typename... Args>
+  bool route(Args&&... args)
+  {
+    std::unique_ptr<rtde_interface::RTDEPackage> package(new T(std::forward<Args>(args)...));
+    const bool consumed = channel_.route(package);
+    if (!consumed)
+    {
+      // A package that is passed on has to stay untouched
+      EXPECT_NE(package, nullptr);
+    }
+    return consumed;
+  }
+
+  rtde_interface::ControlChannel channel_;
+  const std::chrono::milliseconds timeout_ = std::chrono::milliseconds(100);
+};
+
+TEST_F(ControlChannelTest, reply_is_handed_to_waiting_request)
+{
+  auto reply = channel_.expectReply(rtde_interface::PackageType::RTDE_CONTROL_PACKAGE_START);
+
+  EXPECT_TRUE(route<rtde_interface::ControlPackageStart>());
+
+  auto package = rtde_interface::ControlChannel::waitForReply(reply, timeout_);
+  ASSERT_NE(package, nullptr);
+  EXPECT_NE(dynamic_cast<rtde_interface::ControlPackageStart*>(package.get()), nullptr);
+}
+
+TEST_F(ControlChannelTest, replies_are_matched_by_type)
+{
+  auto start_reply = channel_.expectReply(rtde_interface::PackageType::RTDE_CONTROL_PACKAGE_START);
+  auto pause_reply = channel_.expectReply(rtde_interface::PackageType::RTDE_CONTROL_PACKAGE_PAUSE);
+
+  EXPECT_TRUE(route<rtde_interface::ControlPackagePause>());
+  EXPECT_EQ(rtde_interface::ControlChannel::waitForReply(start_reply, std::chrono::milliseconds(0)), nullptr);
+
+  auto pause = rtde_interface::ControlChannel::waitForReply(pause_reply, timeout_);
+  ASSERT_NE(pause, nullptr);
+  EXPECT_EQ(pause->getType(), rtde_interface::PackageType::RTDE_CONTROL_PACKAGE_PAUSE);
+}
+
+TEST_F(ControlChannelTest, replies_of_same_type_are_matched_in_order)
+{
+  auto first = channel_.expectReply(rtde_interface::PackageType::RTDE_GET_URCONTROL_VERSION);
+  auto second = channel_.expectReply(rtde_interface::PackageType::RTDE_GET_URCONTROL_VERSION);
+
+  EXPECT_TRUE(route<rtde_interface::GetUrcontrolVersion>());
+  EXPECT_EQ(second.future.wait_for(std::chrono::milliseconds(0)), std::future_status::timeout);
+  EXPECT_NE(rtde_interface::ControlChannel::waitForReply(first, timeout_), nullptr);
+
+  EXPECT_TRUE(route<rtde_interface::GetUrcontrolVersion>());
+  EXPECT_NE(rtde_interface::ControlChannel::waitForReply(second, timeout_), nullptr);
+}
+
+TEST_F(ControlChannelTest, data_packages_are_passed_on)
+{
+  auto reply = channel_.expectReply(rtde_interface::PackageType::RTDE_DATA_PACKAGE);
+
+  EXPECT_FALSE(route<rtde_interface::DataPackage>(std::vector<std::string>{ "timestamp" }));
+  EXPECT_EQ(rtde_interface::ControlChannel::waitForReply(reply, std::chrono::milliseconds(0)), nullptr);
+}
+
+TEST_F(ControlChannelTest, text_messages_are_consumed)
+{
+  EXPECT_TRUE(route<rtde_interface::TextMessage>(2));
+}
+
+TEST_F(ControlChannelTest, unexpected_reply_is_discarded)
+{
+  EXPECT_TRUE(route<rtde_interface::ControlPackageStart>());
+
+  // A reply that arrived without a pending request must not be handed to a later request.
+  auto reply = channel_.expectReply(rtde_interface::PackageType::RTDE_CONTROL_PACKAGE_START);
+  EXPECT_EQ(rtde_interface::ControlChannel::waitForReply(reply, std::chrono::milliseconds(10)), nullptr);
+}
+
+TEST_F(ControlChannelTest, wait_times_out_without_reply)
+{
+  auto reply = channel_.expectReply(rtde_interface::PackageType::RTDE_CONTROL_PACKAGE_START);
+
+  const auto start = std::chrono::steady_clock::now();
+  EXPECT_EQ(rtde_interface::ControlChannel::waitForReply(reply, std::chrono::milliseconds(20)), nullptr);
+  EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(20));
+
+  // The reply can still be delivered after a timed out wait as long as the request was not canceled.
+  EXPECT_TRUE(route<rtde_interface::ControlPackageStart>());
+  EXPECT_NE(rtde_interface::ControlChannel::waitForReply(reply, timeout_), nullptr);
+}
+
+TEST_F(ControlChannelTest, late_reply_is_consumed_by_timed_out_request)
+{
+  auto first = channel_.expectReply(rtde_interface::PackageType::RTDE_CONTROL_PACKAGE_START);
+  EXPECT_EQ(rtde_interface::ControlChannel::waitForReply(first, std::chrono::milliseconds(10)), nullptr);
+  auto second = channel_.expectReply(rtde_interface::PackageType::RTDE_CONTROL_PACKAGE_START);
+
+  // The late reply to the first request must not be handed to the second one.
+  std::unique_ptr<rtde_interface::RTDEPackage> late(new rtde_interface::ControlPackageStart());
+  static_cast<rtde_interface::ControlPackageStart*>(late.get())->accepted_ = 0;
+  EXPECT_TRUE(channel_.route(late));
+  EXPECT_EQ(rtde_interface::ControlChannel::waitForReply(second, std::chrono::milliseconds(10)), nullptr);
+
+  std::unique_ptr<rtde_interface::RTDEPackage> answer(new rtde_interface::ControlPackageStart());
+  static_cast<rtde_interface::ControlPackageStart*>(answer.get())->accepted_ = 1;
+  EXPECT_TRUE(channel_.route(answer));
+  auto package = rtde_interface::ControlChannel::waitForReply(second, timeout_);
+  ASSERT_NE(package, nullptr);
+  EXPECT_EQ(static_cast<rtde_interface::ControlPackageStart*>(package.get())->accepted_, 1);
+}
+
+TEST_F(ControlChannelTest, cancel_drops_given_request)
+{
+  auto first = channel_.expectReply(rtde_interface::PackageType::RTDE_CONTROL_PACKAGE_START);
+  auto second = channel_.expectReply(rtde_interface::PackageType::RTDE_CONTROL_PACKAGE_START);
+
+  channel_.cancel(first);
+  EXPECT_EQ(rtde_interface::ControlChannel::waitForReply(first, timeout_), nullptr);
+
+  EXPECT_TRUE(route<rtde_interface::ControlPackageStart>());
+  EXPECT_NE(rtde_interface::ControlChannel::waitForReply(second, timeout_), nullptr);
+
+  // Canceling a request that isn't pending anymore is a no-op
+  channel_.cancel(first);
+  channel_.cancel(second);
+  channel_.cancel(rtde_interface::ControlChannel::Reply());
+}
+
+TEST_F(ControlChannelTest, clear_cancels_all_requests)
+{
+  auto start = channel_.expectReply(rtde_interface::PackageType::RTDE_CONTROL_PACKAGE_START);
+  auto pause = channel_.expectReply(rtde_interface::PackageType::RTDE_CONTROL_PACKAGE_PAUSE);
+
+  channel_.clear();
+  EXPECT_EQ(rtde_interface::ControlChannel::waitForReply(start, timeout_), nullptr);
+  EXPECT_EQ(rtde_interface::ControlChannel::waitForReply(pause, timeout_), nullptr);
+
+  // Replies arriving after clearing are discarded
+  EXPECT_TRUE(route<rtde_interface::ControlPackageStart>());
+}
+
+int main(int argc, char* argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+
+  return RUN_ALL_TESTS();
+}
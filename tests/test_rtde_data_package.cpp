@@ -56,6 +56,61 @@ TEST(rtde_data_package, serialize_pkg)
   std::cout << std::endl;
 }
 
+TEST(rtde_data_package, get_packed_bit_registers)
+{
+  std::vector<std::string> recipe{ "output_bit_registers0_to_31", "output_bit_registers32_to_63" };
+  rtde_interface::DataPackage package(recipe);
+  package.initEmpty();
+
+  uint32_t low = 0x00000005;
+  uint32_t high = 0x80000000;
+  package.setData("output_bit_registers0_to_31", low);
+  package.setData("output_bit_registers32_to_63", high);
+
+  bool bit = false;
+  EXPECT_TRUE(package.getData("output_bit_register_0", bit));
+  EXPECT_TRUE(bit);
+  EXPECT_TRUE(package.getData("output_bit_register_1", bit));
+  EXPECT_FALSE(bit);
+  EXPECT_TRUE(package.getData("output_bit_register_2", bit));
+  EXPECT_TRUE(bit);
+  EXPECT_TRUE(package.getData("output_bit_register_63", bit));
+  EXPECT_TRUE(bit);
+
+  // Registers above 63 have no packed representation
+  EXPECT_FALSE(package.getData("output_bit_register_64", bit));
+  EXPECT_FALSE(package.getData("output_bit_register_", bit));
+}
+
+TEST(rtde_data_package, access_fields_by_position)
+{
+  std::vector<std::string> recipe{ "timestamp", "speed_scaling", "no_such_field" };
+  rtde_interface::DataPackage package(recipe);
+
+  size_t index;
+  ASSERT_TRUE(package.findField("speed_scaling", index));
+  EXPECT_EQ(index, 1u);
+  EXPECT_FALSE(package.findField("no_such_field", index));
+  EXPECT_FALSE(package.findField("actual_q", index));
+
+  // Fields hold no values before the package has been filled
+  EXPECT_EQ(package.getDataAt(1), nullptr);
+  package.initEmpty();
+  double speed_scaling = 0.5;
+  package.setData("speed_scaling", speed_scaling);
+  const rtde_interface::DataPackage::_rtde_type_variant* value = package.getDataAt(1);
+  ASSERT_NE(value, nullptr);
+  EXPECT_EQ(std::get<double>(*value), 0.5);
+  EXPECT_EQ(package.getDataAt(2), nullptr);
+  EXPECT_EQ(package.getDataAt(3), nullptr);
+
+  // Copies share the recipe
+  rtde_interface::DataPackage copy(package);
+  EXPECT_EQ(copy.getRecipe(), package.getRecipe());
+  EXPECT_TRUE(copy.getData("speed_scaling", speed_scaling));
+  EXPECT_EQ(speed_scaling, 0.5);
+}
+
 int main(int argc, char* argv[])
 {
   ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,174 @@
+// -- BEGIN LICENSE BLOCK ----------------------------------------------
+// Copyright 2026 Universal Robots A/S
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -- END LICENSE BLOCK ------------------------------------------------
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <ur_client_library/rtde/edge_monitor.h>
+#include <ur_client_library/rtde/rtde_client.h>
+
+using namespace urcl;
+
+class EdgeMonitorTest : public ::testing::Test
+{
+protected:
+  void process(uint32_t safety_status_bits, double speed_scaling)
+  {
+    rtde_interface::DataPackage package({ "safety_status_bits", "speed_scaling" });
+    package.initEmpty();
+    package.setData("safety_status_bits", safety_status_bits);
+    package.setData("speed_scaling", speed_scaling);
+    monitor_.process(package);
+  }
+
+  rtde_interface::EdgeMonitor monitor_;
+};
+
+TEST_F(EdgeMonitorTest, rejects_unknown_and_non_scalar_fields)
+{
+  auto callback = [](const rtde_interface::DataPackage::_rtde_type_variant&,
+                     const rtde_interface::DataPackage::_rtde_type_variant&) {};
+  EXPECT_FALSE(monitor_.addCallback("no_such_field", callback));
+  EXPECT_FALSE(monitor_.addCallback("actual_q", callback));
+  EXPECT_TRUE(monitor_.empty());
+
+  EXPECT_TRUE(monitor_.addCallback("safety_status_bits", callback));
+  EXPECT_FALSE(monitor_.empty());
+}
+
+TEST_F(EdgeMonitorTest, calls_back_on_changes_only)
+{
+  std::vector<std::pair<uint32_t, uint32_t>> changes;
+  ASSERT_TRUE(monitor_.addCallback("safety_status_bits",
+                                   [&changes](const rtde_interface::DataPackage::_rtde_type_variant& previous,
+                                              const rtde_interface::DataPackage::_rtde_type_variant& current) {
+                                     changes.emplace_back(std::get<uint32_t>(previous), std::get<uint32_t>(current));
+                                   }));
+
+  // The first package only initializes the previous value
+  process(1, 1.0);
+  EXPECT_TRUE(changes.empty());
+
+  process(1, 0.5);
+  EXPECT_TRUE(changes.empty());
+
+  process(3, 0.5);
+  ASSERT_EQ(changes.size(), 1u);
+  EXPECT_EQ(changes[0].first, 1u);
+  EXPECT_EQ(changes[0].second, 3u);
+
+  // A package without the watched field is ignored
+  rtde_interface::DataPackage other({ "speed_scaling" });
+  other.initEmpty();
+  monitor_.process(other);
+  process(3, 0.5);
+  EXPECT_EQ(changes.size(), 1u);
+}
+
+TEST_F(EdgeMonitorTest, watches_packed_bit_registers)
+{
+  std::vector<std::pair<bool, bool>> changes;
+  ASSERT_TRUE(monitor_.addCallback("output_bit_register_2",
+                                   [&changes](const rtde_interface::DataPackage::_rtde_type_variant& previous,
+                                              const rtde_interface::DataPackage::_rtde_type_variant& current) {
+                                     changes.emplace_back(std::get<bool>(previous), std::get<bool>(current));
+                                   }));
+
+  // Packages of the same parser share their recipe, so the register is looked up only once.
+  auto recipe = std::make_shared<const std::vector<std::string>>(
+      std::vector<std::string>{ "timestamp", "output_bit_registers0_to_31" });
+  for (uint32_t word : { 0x0u, 0x1u, 0x5u, 0x4u, 0x0u })
+  {
+    rtde_interface::DataPackage package(recipe);
+    package.initEmpty();
+    package.setData("output_bit_registers0_to_31", word);
+    monitor_.process(package);
+  }
+
+  ASSERT_EQ(changes.size(), 2u);
+  EXPECT_EQ(changes[0], std::make_pair(false, true));
+  EXPECT_EQ(changes[1], std::make_pair(true, false));
+}
+
+TEST_F(EdgeMonitorTest, counts_overruns)
+{
+  monitor_.setBudget(std::chrono::microseconds(100));
+  ASSERT_TRUE(monitor_.addCallback("speed_scaling", [](const rtde_interface::DataPackage::_rtde_type_variant&,
+                                                       const rtde_interface::DataPackage::_rtde_type_variant&) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  }));
+
+  process(0, 1.0);
+  process(0, 0.5);
+  EXPECT_EQ(monitor_.getOverruns(), 1u);
+}
+
+TEST_F(EdgeMonitorTest, add_callback_while_processing)
+{
+  std::atomic<bool> running{ true };
+  std::thread producer([this, &running]() {
+    double speed_scaling = 0.0;
+    while (running)
+    {
+      process(0, speed_scaling);
+      speed_scaling = 1.0 - speed_scaling;
+    }
+  });
+
+  std::atomic<size_t> calls{ 0 };
+  for (size_t i = 0; i < 100; ++i)
+  {
+    ASSERT_TRUE(monitor_.addCallback("speed_scaling", [&calls](const rtde_interface::DataPackage::_rtde_type_variant&,
+                                                               const rtde_interface::DataPackage::_rtde_type_variant&) {
+      ++calls;
+    }));
+  }
+  const auto start = std::chrono::steady_clock::now();
+  while (calls == 0 && std::chrono::steady_clock::now() - start < std::chrono::seconds(1))
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  running = false;
+  producer.join();
+  EXPECT_GT(calls, 0u);
+}
+
+TEST(RTDEClientEdgeCallbackTest, rejects_fields_outside_output_recipe)
+{
+  comm::INotifier notifier;
+  rtde_interface::RTDEClient client("127.0.0.1", notifier,
+                                    { "timestamp", "safety_status_bits", "output_bit_register_64",
+                                      "output_bit_register_65", "output_bit_register_66", "output_bit_register_67" },
+                                    {});
+  auto callback = [](const rtde_interface::DataPackage::_rtde_type_variant&,
+                     const rtde_interface::DataPackage::_rtde_type_variant&) {};
+
+  EXPECT_TRUE(client.addEdgeCallback("safety_status_bits", callback));
+  EXPECT_FALSE(client.addEdgeCallback("runtime_state", callback));
+
+  // The bit registers are transferred as one packed word, but can still be watched individually
+  EXPECT_TRUE(client.addEdgeCallback("output_bit_register_65", callback));
+  EXPECT_FALSE(client.addEdgeCallback("output_bit_register_68", callback));
+}
+
+int main(int argc, char* argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,102 @@
+// -- BEGIN LICENSE BLOCK ----------------------------------------------
+// Copyright 2026 Universal Robots A/S
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -- END LICENSE BLOCK ------------------------------------------------
+
+#include <gtest/gtest.h>
+
+#include <ur_client_library/rtde/negotiation_cache.h>
+
+using namespace urcl;
+
+class NegotiationCacheTest : public ::testing::Test
+{
+protected:
+  void SetUp()
+  {
+    key_ = { "192.168.56.101", 30004, { "timestamp", "actual_q" }, { "speed_slider_mask" } };
+    result_.protocol_version = 2;
+    result_.urcontrol_version.major = 5;
+    result_.urcontrol_version.minor = 12;
+  }
+
+  rtde_interface::NegotiationCache cache_;
+  rtde_interface::NegotiationKey key_;
+  rtde_interface::NegotiationResult result_;
+};
+
+TEST_F(NegotiationCacheTest, stores_and_looks_up_results)
+{
+  rtde_interface::NegotiationResult result;
+  EXPECT_FALSE(cache_.lookup(key_, result));
+
+  cache_.store(key_, result_);
+  ASSERT_TRUE(cache_.lookup(key_, result));
+  EXPECT_EQ(result.protocol_version, 2);
+  EXPECT_EQ(result.urcontrol_version.major, 5u);
+  EXPECT_EQ(result.urcontrol_version.minor, 12u);
+
+  result_.protocol_version = 1;
+  cache_.store(key_, result_);
+  ASSERT_TRUE(cache_.lookup(key_, result));
+  EXPECT_EQ(result.protocol_version, 1);
+}
+
+TEST_F(NegotiationCacheTest, key_includes_port_and_recipes)
+{
+  cache_.store(key_, result_);
+  rtde_interface::NegotiationResult result;
+
+  auto other = key_;
+  other.host = "192.168.56.102";
+  EXPECT_FALSE(cache_.lookup(other, result));
+
+  other = key_;
+  other.port = 30005;
+  EXPECT_FALSE(cache_.lookup(other, result));
+
+  other = key_;
+  other.output_recipe.push_back("actual_qd");
+  EXPECT_FALSE(cache_.lookup(other, result));
+
+  other = key_;
+  other.input_recipe.clear();
+  EXPECT_FALSE(cache_.lookup(other, result));
+
+  other = key_;
+  EXPECT_TRUE(cache_.lookup(other, result));
+}
+
+TEST_F(NegotiationCacheTest, erase_and_clear)
+{
+  auto other = key_;
+  other.port = 30005;
+  cache_.store(key_, result_);
+  cache_.store(other, result_);
+
+  rtde_interface::NegotiationResult result;
+  cache_.erase(key_);
+  EXPECT_FALSE(cache_.lookup(key_, result));
+  EXPECT_TRUE(cache_.lookup(other, result));
+
+  cache_.clear();
+  EXPECT_FALSE(cache_.lookup(other, result));
+}
+
+int main(int argc, char* argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+
+  return RUN_ALL_TESTS();
+}
@@ -105,6 +105,67 @@ TEST(rtde_parser, test_illegal_length)
   EXPECT_FALSE(parser.parse(bp, products));
 }
 
+TEST(rtde_parser, reconfigure_rollback)
+{
+  const std::vector<std::string> previous_recipe = { "timestamp", "target_speed_fraction" };
+  const std::vector<std::string> new_recipe = { "timestamp", "runtime_state" };
+
+  // timestamp = 1.5, target_speed_fraction = 0.5
+  unsigned char previous_data[] = { 0x00, 0x14, 0x55, 0x01, 0x3f, 0xf8, 0x00, 0x00, 0x00, 0x00,
+                                    0x00, 0x00, 0x3f, 0xe0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 };
+  // timestamp = 1.5, runtime_state = 2
+  unsigned char new_data[] = { 0x00, 0x10, 0x55, 0x01, 0x3f, 0xf8, 0x00, 0x00,
+                               0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02 };
+  // Output setup reply rejecting runtime_state: "DOUBLE,NOT_FOUND"
+  unsigned char rejected_setup[] = { 0x00, 0x14, 0x4f, 0x01, 'D', 'O', 'U', 'B', 'L', 'E',
+                                     ',',  'N',  'O',  'T',  '_', 'F', 'O', 'U', 'N', 'D' };
+
+  rtde_interface::RTDEParser parser(previous_recipe);
+  std::vector<std::unique_ptr<rtde_interface::RTDEPackage>> products;
+
+  // The robot rejects the new recipe, so the client doesn't switch the parser
+  comm::BinParser setup_bp(rejected_setup, sizeof(rejected_setup));
+  ASSERT_TRUE(parser.parse(setup_bp, products));
+  ASSERT_EQ(products.size(), 1u);
+  auto setup = dynamic_cast<rtde_interface::ControlPackageSetupOutputs*>(products[0].get());
+  ASSERT_NE(setup, nullptr);
+  EXPECT_NE(setup->variable_types_.find("NOT_FOUND"), std::string::npos);
+
+  products.clear();
+  comm::BinParser unchanged_bp(previous_data, sizeof(previous_data));
+  ASSERT_TRUE(parser.parse(unchanged_bp, products));
+  ASSERT_EQ(products.size(), 1u);
+  double speed_fraction = 0.0;
+  EXPECT_TRUE(static_cast<rtde_interface::DataPackage*>(products[0].get())->getData("target_speed_fraction",
+                                                                                      speed_fraction));
+  EXPECT_DOUBLE_EQ(speed_fraction, 0.5);
+
+  // Switching to the new recipe after a confirmed setup, packages in the previous layout are rejected
+  parser.setRecipe(new_recipe);
+  products.clear();
+  comm::BinParser new_bp(new_data, sizeof(new_data));
+  ASSERT_TRUE(parser.parse(new_bp, products));
+  ASSERT_EQ(products.size(), 1u);
+  uint32_t runtime_state = 0;
+  EXPECT_TRUE(static_cast<rtde_interface::DataPackage*>(products[0].get())->getData("runtime_state", runtime_state));
+  EXPECT_EQ(runtime_state, 2u);
+
+  products.clear();
+  comm::BinParser stale_bp(previous_data, sizeof(previous_data));
+  EXPECT_FALSE(parser.parse(stale_bp, products));
+
+  // Restoring the previous configuration makes the previous layout parse again
+  parser.setRecipe(previous_recipe);
+  products.clear();
+  comm::BinParser restored_bp(previous_data, sizeof(previous_data));
+  ASSERT_TRUE(parser.parse(restored_bp, products));
+  ASSERT_EQ(products.size(), 1u);
+  double timestamp = 0.0;
+  EXPECT_TRUE(static_cast<rtde_interface::DataPackage*>(products[0].get())->getData("timestamp", timestamp));
+  EXPECT_DOUBLE_EQ(timestamp, 1.5);
+  EXPECT_FALSE(static_cast<rtde_interface::DataPackage*>(products[0].get())->getData("runtime_state", runtime_state));
+}
+
 int main(int argc, char* argv[])
 {
   ::testing::InitGoogleTest(&argc, argv);
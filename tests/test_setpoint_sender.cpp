@@ -0,0 +1,222 @@
+// -- BEGIN LICENSE BLOCK ----------------------------------------------
+// Copyright 2026 Universal Robots A/S
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -- END LICENSE BLOCK ------------------------------------------------
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+#include <ur_client_library/comm/tcp_socket.h>
+#include <ur_client_library/control/setpoint_sender.h>
+
+using namespace urcl;
+
+TEST(setpoint_mailbox, fetch_returns_newest_value_once)
+{
+  control::SetpointMailbox<int> mailbox;
+  int value = 0;
+  EXPECT_FALSE(mailbox.fetch(value));
+
+  mailbox.publish(1);
+  mailbox.publish(2);
+  mailbox.publish(3);
+  ASSERT_TRUE(mailbox.fetch(value));
+  EXPECT_EQ(value, 3);
+  EXPECT_FALSE(mailbox.fetch(value));
+
+  for (int i = 4; i < 10; ++i)
+  {
+    mailbox.publish(i);
+    ASSERT_TRUE(mailbox.fetch(value));
+    EXPECT_EQ(value, i);
+  }
+}
+
+TEST(setpoint_mailbox, concurrent_values_are_monotonic)
+{
+  control::SetpointMailbox<std::array<int, 16>> mailbox;
+  const int num_values = 200000;
+  std::thread writer([&mailbox]() {
+    std::array<int, 16> value;
+    for (int i = 1; i <= num_values; ++i)
+    {
+      value.fill(i);
+      mailbox.publish(value);
+    }
+  });
+
+  std::array<int, 16> value;
+  int last = 0;
+  while (last < num_values)
+  {
+    if (mailbox.fetch(value))
+    {
+      for (auto element : value)
+      {
+        ASSERT_EQ(element, value[0]);
+      }
+      ASSERT_GT(value[0], last);
+      last = value[0];
+    }
+  }
+  writer.join();
+}
+
+class SetpointSenderTest : public ::testing::Test
+{
+protected:
+  class Client : public comm::TCPSocket
+  {
+  public:
+    Client(const int& port)
+    {
+      std::string host = "127.0.0.1";
+      TCPSocket::setup(host, port);
+    }
+
+    // Reads everything that arrives until the stream is idle for 200ms
+    std::vector<int32_t> receive()
+    {
+      timeval tv;
+      tv.tv_sec = 0;
+      tv.tv_usec = 200000;
+      TCPSocket::setReceiveTimeout(tv);
+
+      std::vector<uint8_t> bytes;
+      uint8_t buffer[4096];
+      size_t read = 0;
+      while (TCPSocket::read(buffer, sizeof(buffer), read) && read > 0)
+      {
+        bytes.insert(bytes.end(), buffer, buffer + read);
+      }
+      std::vector<int32_t> values(bytes.size() / sizeof(int32_t));
+      std::memcpy(values.data(), bytes.data(), values.size() * sizeof(int32_t));
+      for (auto& value : values)
+      {
+        value = be32toh(value);
+      }
+      return values;
+    }
+  };
+
+  void SetUp()
+  {
+    interface_.reset(new control::ReverseInterface(0, [](bool) {}));
+    client_.reset(new Client(interface_->getPort()));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    // Tests run unprivileged, so don't ask for real-time scheduling.
+    config_.priority = 0;
+    config_.lock_memory = false;
+  }
+
+  void TearDown()
+  {
+    client_.reset();
+    interface_.reset();
+  }
+
+  control::RealtimeConfig config_;
+  std::unique_ptr<control::ReverseInterface> interface_;
+  std::unique_ptr<Client> client_;
+};
+
+TEST_F(SetpointSenderTest, sends_keepalives_without_setpoint)
+{
+  control::SetpointSender sender(*interface_, std::chrono::milliseconds(2), 5);
+  sender.start(config_);
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  sender.stop();
+
+  std::vector<int32_t> received = client_->receive();
+  ASSERT_GT(received.size(), 0u);
+  ASSERT_EQ(received.size() % 8, 0u);
+  EXPECT_EQ(received.size() / 8, sender.getKeepaliveCount());
+  EXPECT_EQ(sender.getSentCount(), 0u);
+  for (size_t i = 0; i < received.size(); i += 8)
+  {
+    EXPECT_EQ(received[i + 7], toUnderlying(comm::ControlMode::MODE_KEEPALIVE));
+  }
+}
+
+TEST_F(SetpointSenderTest, sends_each_setpoint_once)
+{
+  control::SetpointSender sender(*interface_, std::chrono::milliseconds(2), 5);
+  sender.start(config_);
+  vector6d_t positions = { 0.1, 0.2, 0.3, 0.4, 0.5, 0.6 };
+  sender.publish(positions, comm::ControlMode::MODE_SERVOJ);
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  sender.stop();
+
+  EXPECT_EQ(sender.getSentCount(), 1u);
+  EXPECT_GT(sender.getKeepaliveCount(), 0u);
+
+  std::vector<int32_t> received = client_->receive();
+  ASSERT_EQ(received.size() % 8, 0u);
+  ASSERT_EQ(received.size() / 8, sender.getSentCount() + sender.getKeepaliveCount());
+
+  // Keepalives don't carry the setpoint, so the robot doesn't execute it again.
+  size_t setpoints = 0;
+  for (size_t i = 0; i < received.size(); i += 8)
+  {
+    if (received[i + 7] == toUnderlying(comm::ControlMode::MODE_SERVOJ))
+    {
+      EXPECT_EQ(received[i + 1], 100000);
+      EXPECT_EQ(received[i + 6], 600000);
+      ++setpoints;
+    }
+    else
+    {
+      EXPECT_EQ(received[i + 7], toUnderlying(comm::ControlMode::MODE_KEEPALIVE));
+      EXPECT_EQ(received[i + 1], 0);
+    }
+  }
+  EXPECT_EQ(setpoints, 1u);
+}
+
+TEST_F(SetpointSenderTest, keepalive_interval_follows_read_timeout)
+{
+  // A keepalive is due every half read timeout of the robot
+  EXPECT_EQ(control::SetpointSender(*interface_, std::chrono::milliseconds(8)).getKeepaliveCycles(), 1u);
+  EXPECT_EQ(control::SetpointSender(*interface_, std::chrono::milliseconds(2)).getKeepaliveCycles(), 5u);
+  EXPECT_EQ(control::SetpointSender(*interface_, std::chrono::milliseconds(2), 3).getKeepaliveCycles(), 3u);
+}
+
+TEST_F(SetpointSenderTest, cycles_can_be_driven_externally)
+{
+  control::SetpointSender sender(*interface_, std::chrono::milliseconds(2), 3);
+  vector6d_t positions = { 0.1, 0.2, 0.3, 0.4, 0.5, 0.6 };
+  sender.publish(positions, comm::ControlMode::MODE_SERVOJ);
+  for (int i = 0; i < 7; ++i)
+  {
+    sender.sendCycle();
+  }
+  EXPECT_EQ(sender.getSentCount(), 1u);
+  EXPECT_EQ(sender.getKeepaliveCount(), 2u);
+
+  std::vector<int32_t> received = client_->receive();
+  ASSERT_EQ(received.size(), 24u);
+  EXPECT_EQ(received[7], toUnderlying(comm::ControlMode::MODE_SERVOJ));
+  EXPECT_EQ(received[15], toUnderlying(comm::ControlMode::MODE_KEEPALIVE));
+  EXPECT_EQ(received[23], toUnderlying(comm::ControlMode::MODE_KEEPALIVE));
+}
+
+int main(int argc, char* argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+
+  return RUN_ALL_TESTS();
+}
@@ -31,6 +31,8 @@
 #include <gtest/gtest.h>
 #include <condition_variable>
 #include <chrono>
+#include <thread>
+#include <netinet/tcp.h>
 
 #include <ur_client_library/comm/tcp_server.h>
 #include <ur_client_library/comm/tcp_socket.h>
@@ -73,11 +75,14 @@ protected:
       }
       return result.str();
     }
+  };
 
-  protected:
-    virtual bool open(int socket_fd, struct sockaddr* address, size_t address_len)
+  class SetupClient : public comm::TCPSocket
+  {
+  public:
+    bool connect(const int port)
     {
-      return ::connect(socket_fd, address, address_len) == 0;
+      return TCPSocket::setup("127.0.0.1", port);
     }
   };
 
@@ -151,7 +156,14 @@ protected:
     }
   }
 
-  int port_ = 50001;
+  void SetUp()
+  {
+    // Let the operating system pick a free port, so tests can run in parallel.
+    comm::TCPServer server(0);
+    port_ = server.getPort();
+  }
+
+  int port_ = 0;
   std::string message_ = "";
   int client_fd_ = -1;
 
@@ -333,6 +345,170 @@ TEST_F(TCPServerTest, client_connections)
   EXPECT_FALSE(server.write(client3_fd, data, len, written));
 }
 
+TEST_F(TCPServerTest, busy_poll_read)
+{
+  comm::TCPServer server(port_);
+  server.setConnectCallback(
+      std::bind(&TCPServerTest_busy_poll_read_Test::connectionCallback, this, std::placeholders::_1));
+  server.start();
+
+  Client client(port_);
+  EXPECT_TRUE(waitForConnectionCallback());
+
+  comm::BusyPollConfig config;
+  config.enabled = true;
+  config.spin_budget = 100;
+  client.setBusyPolling(config);
+
+  std::string message = "text message\n";
+  size_t len = message.size();
+  const uint8_t* data = reinterpret_cast<const uint8_t*>(message.c_str());
+  size_t written;
+
+  // The message is already there when reading starts, so it is picked up while spinning.
+  ASSERT_TRUE(server.write(client_fd_, data, len, written));
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_EQ(client.recv(), message);
+
+  comm::BusyPollStatistics stats = client.getBusyPollStatistics();
+  EXPECT_EQ(stats.spin_reads + stats.blocking_reads, message.size());
+  EXPECT_GT(stats.spin_reads, 0u);
+
+  // When the message is sent after the spin budget is exhausted, reading falls back to blocking.
+  std::thread sender([&]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    size_t sent;
+    server.write(client_fd_, data, len, sent);
+  });
+  EXPECT_EQ(client.recv(), message);
+  sender.join();
+
+  stats = client.getBusyPollStatistics();
+  EXPECT_EQ(stats.spin_reads + stats.blocking_reads, 2 * message.size());
+  EXPECT_GT(stats.blocking_reads, 0u);
+}
+
+TEST_F(TCPServerTest, receive_timestamp)
+{
+  comm::TCPServer server(port_);
+  server.setConnectCallback(
+      std::bind(&TCPServerTest_receive_timestamp_Test::connectionCallback, this, std::placeholders::_1));
+  server.start();
+
+  Client client(port_);
+  EXPECT_TRUE(waitForConnectionCallback());
+
+  std::string message = "text message\n";
+  size_t len = message.size();
+  const uint8_t* data = reinterpret_cast<const uint8_t*>(message.c_str());
+  size_t written;
+
+  auto before_sending = std::chrono::system_clock::now();
+  ASSERT_TRUE(server.write(client_fd_, data, len, written));
+  EXPECT_EQ(client.recv(), message);
+
+  EXPECT_GE(client.getLastReceiveTime(), before_sending);
+  EXPECT_LE(client.getLastReceiveTime(), std::chrono::system_clock::now());
+}
+
+TEST_F(TCPServerTest, connect_with_limited_tries)
+{
+  SetupClient client;
+  comm::ConnectionConfig config;
+  config.initial_backoff = std::chrono::milliseconds(10);
+  config.max_num_tries = 3;
+  client.setConnectionConfig(config);
+
+  // Nobody is listening on the port, so the connection should fail without retrying forever.
+  auto start = std::chrono::steady_clock::now();
+  EXPECT_FALSE(client.connect(port_));
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+  EXPECT_EQ(client.getState(), comm::SocketState::Invalid);
+
+  comm::TCPServer server(port_);
+  server.start();
+  EXPECT_TRUE(client.connect(port_));
+  EXPECT_EQ(client.getState(), comm::SocketState::Connected);
+}
+
+TEST_F(TCPServerTest, cancel_setup)
+{
+  SetupClient client;
+  comm::ConnectionConfig config;
+  config.initial_backoff = std::chrono::seconds(10);
+  client.setConnectionConfig(config);
+
+  std::thread canceler([&client]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    client.cancelSetup();
+  });
+
+  // Setup would retry forever, but canceling should make it return right away.
+  auto start = std::chrono::steady_clock::now();
+  EXPECT_FALSE(client.connect(port_));
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+  canceler.join();
+}
+
+TEST_F(TCPServerTest, cancel_before_setup)
+{
+  SetupClient client;
+  comm::ConnectionConfig config;
+  config.initial_backoff = std::chrono::seconds(10);
+  client.setConnectionConfig(config);
+
+  // A cancellation issued right before the setup starts must not be lost.
+  client.cancelSetup();
+  auto start = std::chrono::steady_clock::now();
+  EXPECT_FALSE(client.connect(port_));
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+
+  // It only applies to one setup.
+  comm::TCPServer server(port_);
+  server.start();
+  EXPECT_TRUE(client.connect(port_));
+
+  client.close();
+  client.cancelSetup();
+  client.resetSetupCancellation();
+  EXPECT_TRUE(client.connect(port_));
+}
+
+TEST_F(TCPServerTest, keepalive_config)
+{
+  comm::KeepaliveConfig config;
+  config.enabled = true;
+  config.idle = std::chrono::seconds(2);
+  config.interval = std::chrono::seconds(1);
+  config.count = 4;
+  config.user_timeout = std::chrono::milliseconds(3000);
+
+  comm::TCPServer server(port_);
+  server.setKeepaliveConfig(config);
+  server.setConnectCallback(
+      std::bind(&TCPServerTest_keepalive_config_Test::connectionCallback, this, std::placeholders::_1));
+  server.start();
+
+  SetupClient client;
+  client.setKeepaliveConfig(config);
+  ASSERT_TRUE(client.connect(port_));
+  EXPECT_TRUE(waitForConnectionCallback());
+
+  for (const int fd : { client.getSocketFD(), client_fd_ })
+  {
+    int value = 0;
+    socklen_t len = sizeof(value);
+    ASSERT_EQ(getsockopt(fd, SOL_SOCKET, SO_KEEPALIVE, &value, &len), 0);
+    EXPECT_EQ(value, 1);
+    ASSERT_EQ(getsockopt(fd, IPPROTO_TCP, TCP_KEEPIDLE, &value, &len), 0);
+    EXPECT_EQ(value, 2);
+    ASSERT_EQ(getsockopt(fd, IPPROTO_TCP, TCP_KEEPCNT, &value, &len), 0);
+    EXPECT_EQ(value, 4);
+    ASSERT_EQ(getsockopt(fd, IPPROTO_TCP, TCP_USER_TIMEOUT, &value, &len), 0);
+    EXPECT_EQ(value, 3000);
+  }
+}
+
 int main(int argc, char* argv[])
 {
   ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,107 @@
+// -- BEGIN LICENSE BLOCK ----------------------------------------------
+// Copyright 2026 Universal Robots A/S
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -- END LICENSE BLOCK ------------------------------------------------
+
+#include <gtest/gtest.h>
+#include <cmath>
+
+#include <ur_client_library/control/trajectory_interpolator.h>
+
+using namespace urcl;
+
+TEST(TrajectoryInterpolatorTest, passes_through_waypoints)
+{
+  control::TrajectoryInterpolator interpolator(0.002);
+  const double positions[] = { 0.0, 0.1, 0.3, 0.4 };
+  for (size_t i = 0; i < 4; ++i)
+  {
+    vector6d_t position;
+    position.fill(positions[i]);
+    EXPECT_TRUE(interpolator.addWaypoint(position, i * 0.02));
+  }
+
+  vector6d_t setpoint;
+  for (size_t step = 0; step <= 30; ++step)
+  {
+    EXPECT_TRUE(interpolator.next(setpoint));
+    if (step % 10 == 0)
+    {
+      for (size_t j = 0; j < 6; ++j)
+      {
+        EXPECT_NEAR(setpoint[j], positions[step / 10], 1e-9);
+      }
+    }
+  }
+  EXPECT_NEAR(interpolator.getTime(), 0.06, 1e-9);
+
+  // Out of waypoints, the last one is held
+  EXPECT_FALSE(interpolator.next(setpoint));
+  EXPECT_NEAR(setpoint[0], 0.4, 1e-9);
+}
+
+TEST(TrajectoryInterpolatorTest, interpolates_smoothly)
+{
+  control::TrajectoryInterpolator interpolator(0.002);
+  vector6d_t position;
+  for (size_t i = 0; i < 6; ++i)
+  {
+    position.fill(0.1 * i);
+    interpolator.addWaypoint(position, i * 0.02);
+  }
+
+  // On a straight line with equally spaced waypoints, interior segments move at constant speed.
+  vector6d_t setpoint;
+  double last = 0.0;
+  for (size_t step = 0; step <= 80; ++step)
+  {
+    interpolator.next(setpoint);
+    if (step > 10 && step <= 40)
+    {
+      EXPECT_NEAR(setpoint[3] - last, 0.01, 1e-9);
+    }
+    last = setpoint[3];
+  }
+}
+
+TEST(TrajectoryInterpolatorTest, memory_is_bounded)
+{
+  control::TrajectoryInterpolator interpolator(0.01, 4);
+  vector6d_t position = { 0, 0, 0, 0, 0, 0 };
+  EXPECT_TRUE(interpolator.addWaypoint(position, 0.0));
+  EXPECT_TRUE(interpolator.addWaypoint(position, 0.02));
+  // Waypoints need strictly increasing times. Checked while there is still room in the buffer.
+  EXPECT_FALSE(interpolator.addWaypoint(position, 0.0));
+  EXPECT_FALSE(interpolator.addWaypoint(position, 0.02));
+  EXPECT_EQ(interpolator.getNumWaypoints(), 2u);
+
+  EXPECT_TRUE(interpolator.addWaypoint(position, 0.04));
+  EXPECT_TRUE(interpolator.addWaypoint(position, 0.06));
+  EXPECT_FALSE(interpolator.addWaypoint(position, 0.1));
+
+  vector6d_t setpoint;
+  for (size_t step = 0; step < 5; ++step)
+  {
+    interpolator.next(setpoint);
+  }
+  EXPECT_EQ(interpolator.getNumWaypoints(), 3u);
+  EXPECT_TRUE(interpolator.addWaypoint(position, 0.1));
+}
+
+int main(int argc, char* argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+
+  return RUN_ALL_TESTS();
+}
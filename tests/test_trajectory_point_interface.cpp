@@ -0,0 +1,288 @@
+// -- BEGIN LICENSE BLOCK ----------------------------------------------
+// Copyright 2026 Universal Robots A/S
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -- END LICENSE BLOCK ------------------------------------------------
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstring>
+#include <future>
+#include <thread>
+
+#include <ur_client_library/comm/tcp_socket.h>
+#include <ur_client_library/control/trajectory_point_interface.h>
+
+using namespace urcl;
+
+class TrajectoryPointInterfaceTest : public ::testing::Test
+{
+protected:
+  class Client : public comm::TCPSocket
+  {
+  public:
+    Client(const int& port)
+    {
+      std::string host = "127.0.0.1";
+      TCPSocket::setup(host, port);
+      timeval tv;
+      tv.tv_sec = 0;
+      tv.tv_usec = 200000;
+      TCPSocket::setReceiveTimeout(tv);
+    }
+
+    // Returns all values received until the read timed out, converted to host byte order. Reading
+    // goes on until at least \p expected values arrived or a second passed without them.
+    std::vector<int32_t> receiveValues(const size_t expected = 0)
+    {
+      uint8_t buffer[1024];
+      size_t read = 0;
+      const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+      while (true)
+      {
+        if (TCPSocket::read(buffer, sizeof(buffer), read) && read > 0)
+        {
+          pending_.insert(pending_.end(), buffer, buffer + read);
+        }
+        else if (pending_.size() >= expected * sizeof(int32_t) || std::chrono::steady_clock::now() > deadline)
+        {
+          break;
+        }
+      }
+      std::vector<int32_t> values(pending_.size() / sizeof(int32_t));
+      for (size_t i = 0; i < values.size(); ++i)
+      {
+        int32_t value;
+        std::memcpy(&value, pending_.data() + i * sizeof(int32_t), sizeof(int32_t));
+        values[i] = be32toh(value);
+      }
+      pending_.erase(pending_.begin(), pending_.begin() + values.size() * sizeof(int32_t));
+      return values;
+    }
+
+    // Returns the trajectory points received until the read timed out after \p expected points
+    std::vector<std::vector<int32_t>> receivePoints(const size_t expected = 0)
+    {
+      const std::vector<int32_t> values = receiveValues(expected * POINT_LENGTH);
+      std::vector<std::vector<int32_t>> points;
+      for (size_t i = 0; i + POINT_LENGTH <= values.size(); i += POINT_LENGTH)
+      {
+        points.emplace_back(values.begin() + i, values.begin() + i + POINT_LENGTH);
+      }
+      return points;
+    }
+
+    void sendMessage(const control::TrajectoryMessageType type, const int32_t value, const bool split = false)
+    {
+      int32_t message[2] = { htobe32(static_cast<int32_t>(type)), htobe32(value) };
+      const uint8_t* data = reinterpret_cast<const uint8_t*>(message);
+      size_t written;
+      if (split)
+      {
+        // Make sure the interface reassembles messages split across multiple reads
+        TCPSocket::write(data, 3, written);
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        TCPSocket::write(data + 3, sizeof(message) - 3, written);
+      }
+      else
+      {
+        TCPSocket::write(data, sizeof(message), written);
+      }
+    }
+
+    static const size_t POINT_LENGTH = 9;
+
+  private:
+    std::vector<uint8_t> pending_;
+  };
+
+  void SetUp()
+  {
+    interface_.reset(new control::TrajectoryPointInterface(0));
+    client_.reset(new Client(interface_->getPort()));
+
+    positions_.resize(NUM_POINTS, { 0.1, 0.2, 0.3, 0.4, 0.5, 0.6 });
+    goal_times_.resize(NUM_POINTS, 1.0);
+    for (size_t i = 0; i < NUM_POINTS; ++i)
+    {
+      // Makes every point identifiable on the robot side
+      positions_[i][0] = static_cast<double>(i);
+    }
+
+    // Writing an empty batch succeeds as soon as the server registered the client.
+    const auto start = std::chrono::steady_clock::now();
+    while (!interface_->writeTrajectoryPoints(positions_.data(), goal_times_.data(), nullptr, 0, false))
+    {
+      ASSERT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+
+  // Checks that the received points are the trajectory's points starting at \p first.
+  void expectPoints(const std::vector<std::vector<int32_t>>& points, const size_t first)
+  {
+    for (size_t i = 0; i < points.size(); ++i)
+    {
+      ASSERT_EQ(points[i].size(), size_t(Client::POINT_LENGTH));
+      EXPECT_EQ(points[i][0], static_cast<int32_t>((first + i) * control::ReverseInterface::MULT_JOINTSTATE));
+      EXPECT_EQ(points[i][1], static_cast<int32_t>(0.2 * control::ReverseInterface::MULT_JOINTSTATE));
+      EXPECT_EQ(points[i][6], int32_t(control::TrajectoryPointInterface::MULT_TIME));
+      EXPECT_EQ(points[i][7], 0);
+      EXPECT_EQ(points[i][8], int32_t(control::TrajectoryPointInterface::JOINT_POINT));
+    }
+  }
+
+  void TearDown()
+  {
+    client_.reset();
+    interface_.reset();
+  }
+
+  static const size_t NUM_POINTS = 5;
+  std::unique_ptr<control::TrajectoryPointInterface> interface_;
+  std::unique_ptr<Client> client_;
+  std::vector<vector6d_t> positions_;
+  std::vector<float> goal_times_;
+};
+
+TEST_F(TrajectoryPointInterfaceTest, batch_matches_single_point_writes)
+{
+  std::vector<float> blend_radii(NUM_POINTS);
+  for (size_t i = 0; i < NUM_POINTS; ++i)
+  {
+    positions_[i][0] = -0.5 * i;
+    positions_[i][5] = 3.1;
+    goal_times_[i] = 0.5f + i;
+    blend_radii[i] = 0.01f * i;
+  }
+
+  for (size_t i = 0; i < NUM_POINTS; ++i)
+  {
+    ASSERT_TRUE(interface_->writeTrajectoryPoint(&positions_[i], goal_times_[i], blend_radii[i], true));
+  }
+  const std::vector<int32_t> single = client_->receiveValues(NUM_POINTS * 9);
+  ASSERT_EQ(single.size(), NUM_POINTS * 9);
+
+  ASSERT_TRUE(interface_->writeTrajectoryPoints(positions_.data(), goal_times_.data(), blend_radii.data(), NUM_POINTS,
+                                                true));
+  EXPECT_EQ(client_->receiveValues(single.size()), single);
+
+  std::vector<control::TrajectoryPoint> points(NUM_POINTS);
+  for (size_t i = 0; i < NUM_POINTS; ++i)
+  {
+    points[i].positions = positions_[i];
+    points[i].goal_time = goal_times_[i];
+    points[i].blend_radius = blend_radii[i];
+  }
+  ASSERT_TRUE(interface_->writeTrajectoryPoints(points.data(), points.size(), true));
+  EXPECT_EQ(client_->receiveValues(single.size()), single);
+
+  // Decode the last point
+  const int32_t* point = &single[(NUM_POINTS - 1) * 9];
+  EXPECT_EQ(point[0], static_cast<int32_t>(-0.5 * (NUM_POINTS - 1) * control::ReverseInterface::MULT_JOINTSTATE));
+  EXPECT_EQ(point[1], static_cast<int32_t>(0.2 * control::ReverseInterface::MULT_JOINTSTATE));
+  EXPECT_EQ(point[5], static_cast<int32_t>(3.1 * control::ReverseInterface::MULT_JOINTSTATE));
+  EXPECT_EQ(point[6], static_cast<int32_t>(goal_times_.back() * control::TrajectoryPointInterface::MULT_TIME));
+  EXPECT_EQ(point[7], static_cast<int32_t>(blend_radii.back() * control::TrajectoryPointInterface::MULT_TIME));
+  EXPECT_EQ(point[8], int32_t(control::TrajectoryPointInterface::CARTESIAN_POINT));
+}
+
+TEST_F(TrajectoryPointInterfaceTest, batch_without_blend_radii)
+{
+  ASSERT_TRUE(interface_->writeTrajectoryPoints(positions_.data(), goal_times_.data(), nullptr, NUM_POINTS, false));
+  const std::vector<int32_t> values = client_->receiveValues(NUM_POINTS * 9);
+  ASSERT_EQ(values.size(), NUM_POINTS * 9);
+  for (size_t i = 0; i < NUM_POINTS; ++i)
+  {
+    EXPECT_EQ(values[i * 9 + 7], 0);
+    EXPECT_EQ(values[i * 9 + 8], int32_t(control::TrajectoryPointInterface::JOINT_POINT));
+  }
+}
+
+TEST_F(TrajectoryPointInterfaceTest, stream_trajectory_respects_window)
+{
+  std::vector<uint32_t> progress;
+  interface_->setTrajectoryProgressCallback([&progress](uint32_t consumed) { progress.push_back(consumed); });
+
+  interface_->resetProgress();
+  auto result = std::async(std::launch::async, [this]() {
+    return interface_->streamTrajectory(positions_.data(), goal_times_.data(), nullptr, NUM_POINTS, false, 2);
+  });
+
+  auto points = client_->receivePoints(2);
+  ASSERT_EQ(points.size(), 2u);
+  expectPoints(points, 0);
+  client_->sendMessage(control::TrajectoryMessageType::TRAJECTORY_MESSAGE_PROGRESS, 1, true);
+  points = client_->receivePoints(1);
+  ASSERT_EQ(points.size(), 1u);
+  expectPoints(points, 2);
+  client_->sendMessage(control::TrajectoryMessageType::TRAJECTORY_MESSAGE_PROGRESS, 3);
+  points = client_->receivePoints(2);
+  ASSERT_EQ(points.size(), 2u);
+  expectPoints(points, 3);
+
+  ASSERT_EQ(result.wait_for(std::chrono::seconds(1)), std::future_status::ready);
+  EXPECT_TRUE(result.get());
+  EXPECT_EQ(interface_->getConsumedPoints(), 3u);
+  EXPECT_EQ(progress, std::vector<uint32_t>({ 1, 3 }));
+}
+
+TEST_F(TrajectoryPointInterfaceTest, stream_trajectory_stops_on_result)
+{
+  std::promise<control::TrajectoryResult> trajectory_result;
+  interface_->setTrajectoryEndCallback(
+      [&trajectory_result](control::TrajectoryResult result) { trajectory_result.set_value(result); });
+
+  interface_->resetProgress();
+  auto result = std::async(std::launch::async, [this]() {
+    return interface_->streamTrajectory(positions_.data(), goal_times_.data(), nullptr, NUM_POINTS, false, 2);
+  });
+
+  auto points = client_->receivePoints(2);
+  ASSERT_EQ(points.size(), 2u);
+  expectPoints(points, 0);
+  client_->sendMessage(control::TrajectoryMessageType::TRAJECTORY_MESSAGE_RESULT,
+                       static_cast<int32_t>(control::TrajectoryResult::TRAJECTORY_RESULT_CANCELED));
+
+  ASSERT_EQ(result.wait_for(std::chrono::seconds(1)), std::future_status::ready);
+  EXPECT_FALSE(result.get());
+  auto ended = trajectory_result.get_future();
+  ASSERT_EQ(ended.wait_for(std::chrono::seconds(1)), std::future_status::ready);
+  EXPECT_EQ(ended.get(), control::TrajectoryResult::TRAJECTORY_RESULT_CANCELED);
+  EXPECT_EQ(client_->receivePoints().size(), 0u);
+}
+
+TEST_F(TrajectoryPointInterfaceTest, result_before_streaming_is_kept)
+{
+  std::promise<control::TrajectoryResult> trajectory_result;
+  interface_->setTrajectoryEndCallback(
+      [&trajectory_result](control::TrajectoryResult result) { trajectory_result.set_value(result); });
+
+  // The robot cancels the trajectory right after it has been started, before any point was sent.
+  interface_->resetProgress();
+  client_->sendMessage(control::TrajectoryMessageType::TRAJECTORY_MESSAGE_RESULT,
+                       static_cast<int32_t>(control::TrajectoryResult::TRAJECTORY_RESULT_CANCELED));
+  auto ended = trajectory_result.get_future();
+  ASSERT_EQ(ended.wait_for(std::chrono::seconds(1)), std::future_status::ready);
+  EXPECT_EQ(ended.get(), control::TrajectoryResult::TRAJECTORY_RESULT_CANCELED);
+
+  EXPECT_FALSE(interface_->streamTrajectory(positions_.data(), goal_times_.data(), nullptr, NUM_POINTS, false, 2));
+  EXPECT_EQ(client_->receivePoints().size(), 0u);
+}
+
+int main(int argc, char* argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,141 @@
+// -- BEGIN LICENSE BLOCK ----------------------------------------------
+// Copyright 2026 Universal Robots A/S
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -- END LICENSE BLOCK ------------------------------------------------
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+#include <ur_client_library/primary/robot_message/version_message.h>
+#include <ur_client_library/ur/calibration_checker.h>
+#include <ur_client_library/ur/ur_driver.h>
+
+using namespace urcl;
+
+std::shared_ptr<primary_interface::KinematicsInfo> makeKinematicsInfo(const double value)
+{
+  auto kin_info = std::make_shared<primary_interface::KinematicsInfo>(primary_interface::RobotStateType::KINEMATICS_INFO);
+  kin_info->dh_theta_.fill(value);
+  kin_info->dh_a_.fill(value);
+  kin_info->dh_d_.fill(value);
+  kin_info->dh_alpha_.fill(value);
+  return kin_info;
+}
+
+TEST(CalibrationCheckerTest, wait_times_out_without_kinematics_info)
+{
+  CalibrationChecker checker(makeKinematicsInfo(1.0)->toHash());
+  checker.consume(std::make_shared<primary_interface::VersionMessage>(0, 0));
+
+  const auto start = std::chrono::steady_clock::now();
+  EXPECT_FALSE(checker.waitForCheck(std::chrono::milliseconds(50)));
+  EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(50));
+  EXPECT_FALSE(checker.isChecked());
+  EXPECT_FALSE(checker.checkSuccessful());
+}
+
+TEST(CalibrationCheckerTest, wait_returns_once_checked)
+{
+  CalibrationChecker checker(makeKinematicsInfo(1.0)->toHash());
+
+  std::thread producer([&checker]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    checker.consume(makeKinematicsInfo(1.0));
+  });
+  EXPECT_TRUE(checker.waitForCheck(std::chrono::seconds(5)));
+  producer.join();
+
+  EXPECT_TRUE(checker.isChecked());
+  EXPECT_TRUE(checker.checkSuccessful());
+}
+
+TEST(CalibrationCheckerTest, cancel_interrupts_wait)
+{
+  CalibrationChecker checker(makeKinematicsInfo(1.0)->toHash());
+
+  std::thread canceler([&checker]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    checker.cancel();
+  });
+  const auto start = std::chrono::steady_clock::now();
+  EXPECT_FALSE(checker.waitForCheck(std::chrono::seconds(5)));
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+  canceler.join();
+  EXPECT_FALSE(checker.isChecked());
+}
+
+TEST(CalibrationCheckerTest, detects_mismatching_calibration)
+{
+  CalibrationChecker checker(makeKinematicsInfo(1.0)->toHash());
+  checker.consume(makeKinematicsInfo(2.0));
+
+  EXPECT_TRUE(checker.waitForCheck(std::chrono::milliseconds(0)));
+  EXPECT_FALSE(checker.checkSuccessful());
+}
+
+TEST(StartupTimingsTest, measure_duration_returns_result)
+{
+  std::chrono::microseconds duration(0);
+  const int result = measureDuration(duration, []() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    return 42;
+  });
+
+  EXPECT_EQ(result, 42);
+  EXPECT_GE(duration, std::chrono::milliseconds(20));
+  EXPECT_LT(duration, std::chrono::seconds(5));
+}
+
+TEST(StartupTimingsTest, measure_duration_on_exception)
+{
+  std::chrono::microseconds duration(0);
+  EXPECT_THROW(measureDuration(duration,
+                               []() {
+                                 std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                                 throw std::runtime_error("failed");
+                               }),
+               std::runtime_error);
+  EXPECT_GE(duration, std::chrono::milliseconds(10));
+}
+
+TEST(StartupTimingsTest, concurrent_phases_are_measured_independently)
+{
+  StartupTimings timings;
+  auto first = std::async(std::launch::async, [&timings]() {
+    measureDuration(timings.rtde_init, []() { std::this_thread::sleep_for(std::chrono::milliseconds(50)); });
+  });
+  auto second = std::async(std::launch::async, [&timings]() {
+    measureDuration(timings.secondary_connect, []() { std::this_thread::sleep_for(std::chrono::milliseconds(50)); });
+  });
+  measureDuration(timings.total, [&]() {
+    first.get();
+    second.get();
+  });
+
+  EXPECT_GE(timings.rtde_init, std::chrono::milliseconds(50));
+  EXPECT_GE(timings.secondary_connect, std::chrono::milliseconds(50));
+  EXPECT_GE(timings.total, std::chrono::milliseconds(50));
+  // Both phases ran in parallel, so their sum exceeds the total.
+  EXPECT_LT(timings.total, timings.rtde_init + timings.secondary_connect);
+  EXPECT_EQ(timings.calibration_check, std::chrono::microseconds(0));
+}
+
+int main(int argc, char* argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+
+  return RUN_ALL_TESTS();
+}